@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ability_connection_registry.h"
+
+#include <chrono>
+
+#include "caution.h"
+#include "hichecker.h"
+#include "hilog/log_c.h"
+#include "hilog/log_cpp.h"
+
+namespace OHOS {
+namespace HiviewDFX {
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD002D0B
+#undef LOG_TAG
+#define LOG_TAG "HICHECKER"
+
+namespace {
+constexpr uint32_t HANDLE_GENERATION_SHIFT = 32;
+constexpr uint64_t HANDLE_INDEX_MASK = 0xFFFFFFFFULL;
+}
+
+AbilityConnectionRegistry& AbilityConnectionRegistry::GetInstance()
+{
+    static AbilityConnectionRegistry instance;
+    return instance;
+}
+
+AbilityConnectionRegistry::~AbilityConnectionRegistry()
+{
+    StopAgeScan();
+}
+
+uint64_t AbilityConnectionRegistry::GetNowMs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ConnectionHandle AbilityConnectionRegistry::Connect(uint64_t ownerId, const std::string& ownerName,
+    const std::string& target)
+{
+    return Connect(ownerId, ownerName, target, GetNowMs());
+}
+
+ConnectionHandle AbilityConnectionRegistry::Connect(uint64_t ownerId, const std::string& ownerName,
+    const std::string& target, uint64_t nowMs)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    uint32_t index = AcquireSlot();
+    if (index == INVALID_INDEX) {
+        HILOG_ERROR(LOG_CORE, "ability connection registry is full.");
+        return INVALID_CONNECTION_HANDLE;
+    }
+    uint32_t ownerIndex = GetOrCreateOwner(ownerId, ownerName);
+    Owner& owner = owners_[ownerIndex];
+    Slot& slot = slots_[index];
+    slot.connectTimeMs = nowMs;
+    slot.ownerIndex = ownerIndex;
+    slot.targetId = InternTarget(target);
+    slot.prev = INVALID_INDEX;
+    slot.next = owner.head;
+    slot.inUse = true;
+    slot.reported = false;
+    if (owner.head != INVALID_INDEX) {
+        slots_[owner.head].prev = index;
+    }
+    owner.head = index;
+    owner.count++;
+    liveCount_++;
+    return (static_cast<uint64_t>(slot.generation) << HANDLE_GENERATION_SHIFT) | (index + 1ULL);
+}
+
+bool AbilityConnectionRegistry::Disconnect(ConnectionHandle handle)
+{
+    uint64_t indexPart = handle & HANDLE_INDEX_MASK;
+    if (indexPart == 0) {
+        return false;
+    }
+    uint32_t index = static_cast<uint32_t>(indexPart - 1);
+    uint32_t generation = static_cast<uint32_t>(handle >> HANDLE_GENERATION_SHIFT);
+    std::lock_guard<std::mutex> lock(lock_);
+    if (index >= slots_.size() || !slots_[index].inUse || slots_[index].generation != generation) {
+        return false;
+    }
+    ReleaseSlot(index);
+    return true;
+}
+
+uint32_t AbilityConnectionRegistry::DisconnectOwner(uint64_t ownerId)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto iter = ownerIndex_.find(ownerId);
+    if (iter == ownerIndex_.end()) {
+        return 0;
+    }
+    // the owner entry is recycled together with its last connection
+    uint32_t ownerIndex = iter->second;
+    uint32_t released = owners_[ownerIndex].count;
+    for (uint32_t i = 0; i < released; i++) {
+        ReleaseSlot(owners_[ownerIndex].head);
+    }
+    return released;
+}
+
+uint32_t AbilityConnectionRegistry::GetConnectionCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return liveCount_;
+}
+
+uint32_t AbilityConnectionRegistry::GetOwnerConnectionCount(uint64_t ownerId) const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    auto iter = ownerIndex_.find(ownerId);
+    return iter == ownerIndex_.end() ? 0 : owners_[iter->second].count;
+}
+
+uint32_t AbilityConnectionRegistry::GetOwnerCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return static_cast<uint32_t>(ownerIndex_.size());
+}
+
+uint32_t AbilityConnectionRegistry::GetTargetCount() const
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return static_cast<uint32_t>(targetIndex_.size());
+}
+
+uint32_t AbilityConnectionRegistry::AcquireSlot()
+{
+    if (freeHead_ != INVALID_INDEX) {
+        uint32_t index = freeHead_;
+        freeHead_ = slots_[index].next;
+        return index;
+    }
+    if (slots_.size() >= INVALID_INDEX - 1) {
+        return INVALID_INDEX;
+    }
+    slots_.emplace_back();
+    return static_cast<uint32_t>(slots_.size() - 1);
+}
+
+void AbilityConnectionRegistry::ReleaseSlot(uint32_t index)
+{
+    Slot& slot = slots_[index];
+    Owner& owner = owners_[slot.ownerIndex];
+    if (slot.prev != INVALID_INDEX) {
+        slots_[slot.prev].next = slot.next;
+    } else {
+        owner.head = slot.next;
+    }
+    if (slot.next != INVALID_INDEX) {
+        slots_[slot.next].prev = slot.prev;
+    }
+    owner.count--;
+    liveCount_--;
+    ReleaseTarget(slot.targetId);
+    if (owner.count == 0) {
+        ReleaseOwner(slot.ownerIndex);
+    }
+    slot.inUse = false;
+    slot.generation++;
+    slot.ownerIndex = INVALID_INDEX;
+    slot.prev = INVALID_INDEX;
+    slot.next = freeHead_;
+    freeHead_ = index;
+}
+
+uint32_t AbilityConnectionRegistry::GetOrCreateOwner(uint64_t ownerId, const std::string& ownerName)
+{
+    auto iter = ownerIndex_.find(ownerId);
+    if (iter != ownerIndex_.end()) {
+        return iter->second;
+    }
+    uint32_t index = 0;
+    if (!freeOwners_.empty()) {
+        index = freeOwners_.back();
+        freeOwners_.pop_back();
+    } else {
+        owners_.emplace_back();
+        index = static_cast<uint32_t>(owners_.size() - 1);
+    }
+    Owner& owner = owners_[index];
+    owner.ownerId = ownerId;
+    owner.name = ownerName;
+    owner.head = INVALID_INDEX;
+    owner.count = 0;
+    ownerIndex_.emplace(ownerId, index);
+    return index;
+}
+
+void AbilityConnectionRegistry::ReleaseOwner(uint32_t index)
+{
+    Owner& owner = owners_[index];
+    ownerIndex_.erase(owner.ownerId);
+    std::string().swap(owner.name);
+    owner.head = INVALID_INDEX;
+    freeOwners_.push_back(index);
+}
+
+uint32_t AbilityConnectionRegistry::InternTarget(const std::string& target)
+{
+    auto iter = targetIndex_.find(target);
+    if (iter != targetIndex_.end()) {
+        targets_[iter->second].refs++;
+        return iter->second;
+    }
+    uint32_t id = 0;
+    if (!freeTargets_.empty()) {
+        id = freeTargets_.back();
+        freeTargets_.pop_back();
+    } else {
+        targets_.emplace_back();
+        id = static_cast<uint32_t>(targets_.size() - 1);
+    }
+    targets_[id].name = target;
+    targets_[id].refs = 1;
+    targetIndex_.emplace(target, id);
+    return id;
+}
+
+void AbilityConnectionRegistry::ReleaseTarget(uint32_t id)
+{
+    Target& target = targets_[id];
+    if (--target.refs > 0) {
+        return;
+    }
+    targetIndex_.erase(target.name);
+    std::string().swap(target.name);
+    freeTargets_.push_back(id);
+}
+
+void AbilityConnectionRegistry::SetLeakThreshold(uint64_t thresholdMs)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    leakThresholdMs_ = thresholdMs;
+}
+
+uint32_t AbilityConnectionRegistry::ScanStep(uint64_t nowMs, uint32_t maxSlots)
+{
+    std::vector<LeakRecord> leaks;
+    std::vector<std::string> messages;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        uint32_t slotCount = static_cast<uint32_t>(slots_.size());
+        for (uint32_t i = 0; i < maxSlots && i < slotCount; i++) {
+            if (scanCursor_ >= slotCount) {
+                scanCursor_ = 0;
+            }
+            Slot& slot = slots_[scanCursor_++];
+            if (!slot.inUse || slot.reported || nowMs < slot.connectTimeMs ||
+                nowMs - slot.connectTimeMs < leakThresholdMs_) {
+                continue;
+            }
+            slot.reported = true;
+            leaks.push_back({ slot.ownerIndex, slot.targetId, nowMs - slot.connectTimeMs });
+        }
+        for (const auto& leak : leaks) {
+            messages.push_back("trigger:RULE_CHECK_ABILITY_CONNECTION_LEAK,owner:" + owners_[leak.ownerIndex].name +
+                ",target:" + targets_[leak.targetId].name + ",age:" + std::to_string(leak.ageMs) + "ms");
+        }
+    }
+    for (const auto& msg : messages) {
+        Caution caution(Rule::RULE_CHECK_ABILITY_CONNECTION_LEAK, msg);
+        HiChecker::NotifyAbilityConnectionLeak(caution);
+    }
+    return static_cast<uint32_t>(messages.size());
+}
+
+bool AbilityConnectionRegistry::StartAgeScan(uint32_t intervalMs, uint32_t slotsPerStep)
+{
+    if (intervalMs == 0 || slotsPerStep == 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(scanLock_);
+    if (scanRunning_ || scanStopping_) {
+        return false;
+    }
+    scanRunning_ = true;
+    scanThread_ = std::thread([this, intervalMs, slotsPerStep] { ScanLoop(intervalMs, slotsPerStep); });
+    return true;
+}
+
+void AbilityConnectionRegistry::StopAgeScan()
+{
+    {
+        std::lock_guard<std::mutex> lock(scanLock_);
+        if (!scanRunning_) {
+            return;
+        }
+        scanRunning_ = false;
+        scanStopping_ = true;
+    }
+    scanCond_.notify_all();
+    if (scanThread_.joinable()) {
+        scanThread_.join();
+    }
+    std::lock_guard<std::mutex> lock(scanLock_);
+    scanStopping_ = false;
+}
+
+void AbilityConnectionRegistry::ScanLoop(uint32_t intervalMs, uint32_t slotsPerStep)
+{
+    std::unique_lock<std::mutex> lock(scanLock_);
+    while (scanRunning_) {
+        scanCond_.wait_for(lock, std::chrono::milliseconds(intervalMs), [this] { return !scanRunning_; });
+        if (!scanRunning_) {
+            break;
+        }
+        lock.unlock();
+        if (HiChecker::Contains(Rule::RULE_CHECK_ABILITY_CONNECTION_LEAK)) {
+            ScanStep(GetNowMs(), slotsPerStep);
+        }
+        lock.lock();
+    }
+}
+
+void AbilityConnectionRegistry::Reset()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    // the slots are kept and their generations bumped, a handle issued before the reset stays invalid
+    freeHead_ = INVALID_INDEX;
+    for (uint32_t index = static_cast<uint32_t>(slots_.size()); index > 0; index--) {
+        Slot& slot = slots_[index - 1];
+        if (slot.inUse) {
+            slot.inUse = false;
+            slot.generation++;
+        }
+        slot.ownerIndex = INVALID_INDEX;
+        slot.prev = INVALID_INDEX;
+        slot.next = freeHead_;
+        freeHead_ = index - 1;
+    }
+    owners_.clear();
+    ownerIndex_.clear();
+    freeOwners_.clear();
+    targets_.clear();
+    targetIndex_.clear();
+    freeTargets_.clear();
+    liveCount_ = 0;
+    scanCursor_ = 0;
+}
+} // HiviewDFX
+} // OHOS
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "arkui_perf_checker.h"
+
+#include <algorithm>
+
+#include "caution.h"
+#include "hichecker.h"
+#include "hilog/log_c.h"
+#include "hilog/log_cpp.h"
+
+namespace OHOS {
+namespace HiviewDFX {
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD002D0B
+#undef LOG_TAG
+#define LOG_TAG "HICHECKER"
+
+namespace {
+constexpr uint32_t DEFAULT_BUILD_BUDGET_US = 8000;
+constexpr uint32_t DEFAULT_LAYOUT_BUDGET_US = 4000;
+constexpr uint32_t DEFAULT_RENDER_BUDGET_US = 4000;
+constexpr uint32_t DEFAULT_VIOLATION_COUNT = 5;
+constexpr uint32_t DEFAULT_WINDOW_SIZE = 30;
+constexpr uint32_t PERCENTILE_P50 = 50;
+constexpr uint32_t PERCENTILE_P90 = 90;
+constexpr uint32_t PERCENTILE_P99 = 99;
+constexpr uint32_t PERCENTILE_MAX = 100;
+const char* const PHASE_NAMES[ARKUI_PHASE_COUNT] = { "build", "layout", "render" };
+}
+
+ArkUIPerfChecker& ArkUIPerfChecker::GetInstance()
+{
+    static ArkUIPerfChecker instance;
+    return instance;
+}
+
+ArkUIPerfChecker::ArkUIPerfChecker()
+    : phaseBudgetUs_ { DEFAULT_BUILD_BUDGET_US, DEFAULT_LAYOUT_BUDGET_US, DEFAULT_RENDER_BUDGET_US },
+      violationThreshold_(DEFAULT_VIOLATION_COUNT), windowSize_(DEFAULT_WINDOW_SIZE)
+{
+}
+
+bool ArkUIPerfChecker::ReportFrame(const ArkUIFrameTiming& timing)
+{
+    if (!frameQueue_.Push(timing)) {
+        droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+uint32_t ArkUIPerfChecker::ProcessPendingFrames()
+{
+    bool checkEnabled = HiChecker::Contains(Rule::RULE_CHECK_ARKUI_PERFORMANCE);
+    uint32_t count = 0;
+    ArkUIFrameTiming timing;
+    while (frameQueue_.Pop(timing)) {
+        AnalyzeFrame(timing, checkEnabled);
+        count++;
+    }
+    return count;
+}
+
+void ArkUIPerfChecker::AnalyzeFrame(const ArkUIFrameTiming& timing, bool checkEnabled)
+{
+    uint32_t cautionPhases = 0;
+    {
+        std::lock_guard<std::mutex> lock(windowLock_);
+        for (uint32_t phase = 0; phase < ARKUI_PHASE_COUNT; phase++) {
+            PhaseWindow& window = windows_[phase];
+            if (window.sampleCount == windowSize_ && window.overBudget[cursor_]) {
+                window.violationCount--;
+            }
+            bool overBudget = timing.phaseCostUs[phase] > phaseBudgetUs_[phase];
+            window.costUs[cursor_] = timing.phaseCostUs[phase];
+            window.overBudget[cursor_] = overBudget;
+            window.violationCount += overBudget ? 1 : 0;
+            window.sampleCount = std::min(window.sampleCount + 1, windowSize_);
+            if (checkEnabled && window.violationCount >= violationThreshold_) {
+                cautionPhases |= (1U << phase);
+            }
+        }
+        cursor_ = (cursor_ + 1) % windowSize_;
+    }
+    for (uint32_t phase = 0; phase < ARKUI_PHASE_COUNT; phase++) {
+        if ((cautionPhases & (1U << phase)) != 0) {
+            RaiseCaution(static_cast<ArkUIFramePhase>(phase), timing.frameId);
+        }
+    }
+}
+
+uint32_t ArkUIPerfChecker::CalcPercentile(const PhaseWindow& window, uint32_t percentile) const
+{
+    if (window.sampleCount == 0) {
+        return 0;
+    }
+    uint32_t samples[MAX_WINDOW_SIZE];
+    std::copy(window.costUs, window.costUs + window.sampleCount, samples);
+    uint32_t rank = (window.sampleCount - 1) * std::min(percentile, PERCENTILE_MAX) / PERCENTILE_MAX;
+    std::nth_element(samples, samples + rank, samples + window.sampleCount);
+    return samples[rank];
+}
+
+void ArkUIPerfChecker::RaiseCaution(ArkUIFramePhase phase, uint64_t frameId)
+{
+    std::string tag;
+    {
+        std::lock_guard<std::mutex> lock(windowLock_);
+        PhaseWindow& window = windows_[phase];
+        tag = "phase:" + std::string(PHASE_NAMES[phase]) + ",frame:" + std::to_string(frameId) +
+            ",budget:" + std::to_string(phaseBudgetUs_[phase]) + "us,violations:" +
+            std::to_string(window.violationCount) + "/" + std::to_string(window.sampleCount) +
+            ",p50:" + std::to_string(CalcPercentile(window, PERCENTILE_P50)) +
+            "us,p90:" + std::to_string(CalcPercentile(window, PERCENTILE_P90)) +
+            "us,p99:" + std::to_string(CalcPercentile(window, PERCENTILE_P99)) + "us";
+        std::fill(window.overBudget, window.overBudget + MAX_WINDOW_SIZE, false);
+        window.violationCount = 0;
+        cautionCount_++;
+    }
+    Caution caution(Rule::RULE_CHECK_ARKUI_PERFORMANCE, "");
+    HiChecker::NotifyCaution(Rule::RULE_CHECK_ARKUI_PERFORMANCE, tag, caution);
+}
+
+void ArkUIPerfChecker::SetPhaseBudget(ArkUIFramePhase phase, uint32_t budgetUs)
+{
+    if (phase >= ARKUI_PHASE_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(windowLock_);
+    phaseBudgetUs_[phase] = budgetUs;
+}
+
+uint32_t ArkUIPerfChecker::GetPhaseBudget(ArkUIFramePhase phase) const
+{
+    if (phase >= ARKUI_PHASE_COUNT) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(windowLock_);
+    return phaseBudgetUs_[phase];
+}
+
+bool ArkUIPerfChecker::SetViolationWindow(uint32_t violationCount, uint32_t windowSize)
+{
+    if (windowSize == 0 || windowSize > MAX_WINDOW_SIZE || violationCount == 0 || violationCount > windowSize) {
+        HILOG_ERROR(LOG_CORE, "invalid arkui violation window %{public}u/%{public}u.", violationCount, windowSize);
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(windowLock_);
+    violationThreshold_ = violationCount;
+    windowSize_ = windowSize;
+    for (auto& window : windows_) {
+        window = PhaseWindow();
+    }
+    cursor_ = 0;
+    return true;
+}
+
+uint32_t ArkUIPerfChecker::GetPhasePercentile(ArkUIFramePhase phase, uint32_t percentile) const
+{
+    if (phase >= ARKUI_PHASE_COUNT) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(windowLock_);
+    return CalcPercentile(windows_[phase], percentile);
+}
+
+uint64_t ArkUIPerfChecker::GetDroppedFrameCount() const
+{
+    return droppedFrames_.load(std::memory_order_relaxed);
+}
+
+uint64_t ArkUIPerfChecker::GetCautionCount() const
+{
+    std::lock_guard<std::mutex> lock(windowLock_);
+    return cautionCount_;
+}
+
+void ArkUIPerfChecker::Reset()
+{
+    ArkUIFrameTiming timing;
+    while (frameQueue_.Pop(timing)) {}
+    droppedFrames_.store(0, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(windowLock_);
+    for (auto& window : windows_) {
+        window = PhaseWindow();
+    }
+    cursor_ = 0;
+    cautionCount_ = 0;
+}
+} // HiviewDFX
+} // OHOS
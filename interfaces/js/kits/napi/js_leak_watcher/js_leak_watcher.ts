@@ -17,14 +17,15 @@ declare function requireNapi(napiModuleName: string): any;
 declare function registerArkUIObjectLifeCycleCallback(callback: (weakRef: WeakRef<object>, msg: string) => void);
 declare function unregisterArkUIObjectLifeCycleCallback();
 
-let util = requireNapi('util');
-let fs = requireNapi('file.fs');
-let hidebug = requireNapi('hidebug');
-let process = requireNapi('process');
-let cryptoFramework = requireNapi('security.cryptoFramework');
-let jsLeakWatcherNative = requireNapi('hiviewdfx.jsleakwatchernative');
-let application = requireNapi('app.ability.application');
-let bundleManager = requireNapi('bundle.bundleManager');
+// loaded by initModule on the first API call, importing the module does no work
+let util;
+let fs;
+let hidebug;
+let process;
+let jsLeakWatcherNative;
+let application;
+let bundleManager;
+let moduleInitialized = false;
 
 const SANDBOX_PATH = '/data/storage/el2/base/files/';
 const JSLEAK_ROOT_DIR_NAME = 'jsleak';
@@ -69,25 +70,40 @@ let leakWatcherConfig: LeakWatcherConfig = {
   exclusionList: []
 };
 
-let dumpStatus: boolean = jsLeakWatcherNative.getDumpStatus();
+// read again by dumpInner before every dump
+let dumpStatus: boolean = true;
 
 let retryMonitorObjectTypes: MonitorObjectType | undefined = undefined;
 const ATTEMPT_COUNT = 2;
 let currentAttempt = 1;
 
+// same value as APP_STATE_UNKNOWN on the native side, no state was seeded or reported yet
+const stateUnknown = -1;
 const stateForeground = 1;
 const stateBackground = 3;
 
+// the base name travels with its dump, a later dump must not rename the files of one still running
+interface HeapDumpFile {
+  baseName: string;
+  sha256: string;
+}
+
+// what dumpAsync resolves with, empty paths and a size of 0 when nothing was dumped
+interface DumpResult {
+  leakListPath: string;
+  rawHeapPath: string;
+  fileSize: number;
+  sha256: string;
+}
+
 interface AppStateInformation {
   applicationContext: Context;
   bundleFlags: number;
   bundleName: string;
-  processInformation: any[];
   applicationState: number;
-  exists: any[];
-  currentLeakList: any[];
-  duplicateLeakList: any[];
-  intersection: any[];
+  isAppStateFromCallback: boolean;
+  currentLeakCount: number;
+  persistentLeakCount: number;
   leakListPath: string[];
   isConfigObj: boolean;
   isGC: boolean;
@@ -96,15 +112,13 @@ interface AppStateInformation {
 }
 
 let appState: AppStateInformation = {
-  applicationContext: getApplicationContext(),
-  bundleFlags: bundleManager.BundleFlag.GET_BUNDLE_INFO_DEFAULT,
+  applicationContext: undefined,
+  bundleFlags: 0,
   bundleName: '',
-  processInformation: [],
-  applicationState: 2,
-  exists: [],
-  currentLeakList: [],
-  duplicateLeakList: [],
-  intersection: [],
+  applicationState: stateUnknown,
+  isAppStateFromCallback: false,
+  currentLeakCount: 0,
+  persistentLeakCount: 0,
   leakListPath: [],
   isConfigObj: false,
   isGC: true,
@@ -112,58 +126,50 @@ let appState: AppStateInformation = {
   stateBackground: 3
 };
 
-interface ReportRawHeap {
-  pid: number;
-  happenTime: string;
-  module: string;
-  leakList: string;
-  dynamicRawheapPath: string;
-  staticRawheapPath: string;
-  leakListPath: string;
-  leakObjectCount: number;
-}
-
-let report: ReportRawHeap = {
-  pid: process.pid,
-  happenTime: new Date().getTime().toString(),
-  module: '',
-  leakList: '',
-  dynamicRawheapPath: '',
-  staticRawheapPath: '',
-  leakListPath: '',
-  leakObjectCount: 0
-};
-
-let errMap = new Map();
-errMap.set(ERROR_CODE_INVALID_PARAM, ERROR_MSG_INVALID_PARAM);
-errMap.set(ERROR_CODE_ENABLE_INVALID, ERROR_MSG_ENABLE_INVALID);
-errMap.set(ERROR_CODE_CONFIG_INVALID, ERROR_MSG_CONFIG_INVALID);
-errMap.set(ERROR_CODE_CALLBACK_INVALID, ERROR_MSG_CALLBACK_INVALID);
+function getErrorMessage(code): string {
+  switch (code) {
+    case ERROR_CODE_ENABLE_INVALID:
+      return ERROR_MSG_ENABLE_INVALID;
+    case ERROR_CODE_CONFIG_INVALID:
+      return ERROR_MSG_CONFIG_INVALID;
+    case ERROR_CODE_CALLBACK_INVALID:
+      return ERROR_MSG_CALLBACK_INVALID;
+    default:
+      return ERROR_MSG_INVALID_PARAM;
+  }
+}
 
 class BusinessError extends Error {
   constructor(code) {
-    let msg = '';
-    if (errMap.has(code)) {
-      msg = errMap.get(code);
-    } else {
-      msg = ERROR_MSG_INVALID_PARAM;
-    }
-    super(msg);
+    super(getErrorMessage(code));
     this.code = code;
   }
 }
 
 let enabled = false;
-let watchObjMap = new Map();
 let firstDump = true;
-let curTimeStamp = '';
+const LEAK_LIST_BATCH_SIZE = 512;
+
+let registry: FinalizationRegistry<number> | undefined = undefined;
 
-const registry = new FinalizationRegistry((hash) => {
-  if (watchObjMap.has(hash)) {
-    watchObjMap.delete(hash);
+function initModule(): void {
+  if (moduleInitialized) {
+    return;
   }
-});
-let maxFileNum = 20;
+  moduleInitialized = true;
+  util = requireNapi('util');
+  fs = requireNapi('file.fs');
+  hidebug = requireNapi('hidebug');
+  process = requireNapi('process');
+  jsLeakWatcherNative = requireNapi('hiviewdfx.jsleakwatchernative');
+  application = requireNapi('app.ability.application');
+  bundleManager = requireNapi('bundle.bundleManager');
+  appState.applicationContext = getApplicationContext();
+  appState.bundleFlags = bundleManager.BundleFlag.GET_BUNDLE_INFO_DEFAULT;
+  registry = new FinalizationRegistry((hash) => {
+    jsLeakWatcherNative.unregisterLeakObject(hash);
+  });
+}
 
 function getApplicationContext(): Context | undefined {
   try {
@@ -197,44 +203,24 @@ function convertToMask(configArray: string[]): number {
   return mask;
 }
 
-function getJsleaklistFile(filePath, needSandBox, isRawHeap, jsCallback) {
-  if (!dumpStatus) {
-    if (firstDump) {
-      firstDump = false;
-      deleteUnMatchDumpFile(filePath);
-    } else {
-      deleteLastOldFile(filePath);
-    }
+// the watched objects are streamed to the file natively, JS never holds the serialized list
+function writeLeakListFile(leakListFile, isRawHeap, heapDumpSHA256) {
+  const written = jsLeakWatcherNative.writeLeakList(leakListFile, heapDumpSHA256, isRawHeap ? '2.0.0' : '');
+  if (written === undefined) {
+    throw new Error('write leak list failed: ' + leakListFile);
   }
-  let file = dumpStatus ? fs.openSync(filePath + '/' + getHeapBaseName(false) + '.jsleaklist', fs.OpenMode.READ_WRITE | fs.OpenMode.CREATE) :
-    fs.openSync(filePath + '/' + getHeapBaseName(true) + '.jsleaklist', fs.OpenMode.READ_WRITE | fs.OpenMode.CREATE);
-  let leakObjList = getLeakList();
-  let suffix = isRawHeap ? '.rawheap' : '.heapsnapshot';
-  let heapDumpFileName = getHeapBaseName(false) + suffix;
-  let desFilePath = filePath + '/' + heapDumpFileName;
-  const heapDumpSHA256 = dumpStatus ? getHeapDumpSHA256(desFilePath) : '';
-
-  if (isRawHeap) {
-    let result = { version: '2.0.0', snapshot_hash: heapDumpSHA256, leakObjList: leakObjList };
-    fs.writeSync(file.fd, JSON.stringify(result));
-  } else {
-    let result = { snapshot_hash: heapDumpSHA256, leakObjList: leakObjList };
-    fs.writeSync(file.fd, JSON.stringify(result));
-  }
-  fs.closeSync(file);
+  return written;
+}
 
-  try {
-    deleteOldFile(filePath);
-  } catch (e) {
-    console.log('Delete old files failed! ' + e);
-    return [];
-  }
+function getJsleaklistFile(filePath, baseName, needSandBox, isRawHeap, jsCallback, heapDumpSHA256 = '') {
+  writeLeakListFile(filePath + '/' + baseName + '.jsleaklist', isRawHeap, heapDumpSHA256);
+  jsLeakWatcherNative.commitDump(filePath, baseName);
 
   let fileList: string[] = [];
   if (needSandBox) {
-    fileList = [filePath + '/' + getHeapBaseName(false) + '.jsleaklist', dumpStatus ? filePath + '/' + getHeapBaseName(false) + '.rawheap' : ''];
+    fileList = [filePath + '/' + baseName + '.jsleaklist', dumpStatus ? filePath + '/' + baseName + '.rawheap' : ''];
   } else {
-    fileList = [getHeapBaseName(false) + '.jsleaklist', getHeapBaseName(false) + '.heapsnapshot'];
+    fileList = [baseName + '.jsleaklist', baseName + '.heapsnapshot'];
   }
 
   appState.leakListPath = fileList;
@@ -242,8 +228,7 @@ function getJsleaklistFile(filePath, needSandBox, isRawHeap, jsCallback) {
     jsCallback(fileList);
   }
 
-  setReportData();
-  jsLeakWatcherNative.reportRawHeap(report);
+  jsLeakWatcherNative.reportRawHeap(appState.bundleName, JSON.stringify(appState.leakListPath));
   return [];
 }
 
@@ -271,9 +256,9 @@ function setGcDelayAndDumpDelay(configs): void {
 
 function setDumpFileSaveAmount(configs): void {
   if (!configs.maxStoredHeapDumps || configs.maxStoredHeapDumps <= 0) {
-    maxFileNum = leakWatcherConfig.maxStoredHeapDumps * 2;
+    jsLeakWatcherNative.setDumpRetention(leakWatcherConfig.maxStoredHeapDumps);
   } else {
-    maxFileNum = configs.maxStoredHeapDumps * 2;
+    jsLeakWatcherNative.setDumpRetention(configs.maxStoredHeapDumps);
   }
 }
 
@@ -293,6 +278,9 @@ function setWhiteList(configs): void {
 function setForegroundAndBackgroundThreshold(configs): void {
   leakWatcherConfig.fgLeakCountThreshold = configs.fgLeakCountThreshold;
   leakWatcherConfig.bgLeakCountThreshold = configs.bgLeakCountThreshold;
+  if (typeof configs.fgLeakCountThreshold === 'number' && typeof configs.bgLeakCountThreshold === 'number') {
+    jsLeakWatcherNative.setLeakCountThreshold(configs.fgLeakCountThreshold, configs.bgLeakCountThreshold);
+  }
 }
 
 function getCustomAttribute(configs): void {
@@ -305,285 +293,153 @@ function getCustomAttribute(configs): void {
 function setLeakWatcherConfig(configs): void {
   setWhiteList(configs);
   setMonitoredIDAndObjectType(configs);
+  jsLeakWatcherNative.setLeakWatcherFilter(leakWatcherConfig.exclusionList, leakWatcherConfig.objectUniqueIDs);
   setGcDelayAndDumpDelay(configs);
   setForegroundAndBackgroundThreshold(configs);
   setDumpFileSaveAmount(configs);
   getProcessName();
 }
 
-function setReportData(): void {
-  report.pid = process.pid;
-  report.happenTime = new Date().getTime().toString();
-  report.module = appState.bundleName;
-  report.leakList = JSON.stringify(appState.intersection);
-  report.dynamicRawheapPath = JSON.stringify(appState.leakListPath);
-  report.staticRawheapPath = JSON.stringify(appState.leakListPath);
-  report.leakListPath = JSON.stringify(appState.leakListPath);
-  report.leakObjectCount = appState.intersection.length;
+function monitorLeakIDandWhitelist(obj): boolean {
+  return jsLeakWatcherNative.isLeakObjectFiltered(obj.constructor.name, obj.__nativeId__Internal);
 }
 
-function monitorLeakIDandWhitelist(obj): boolean {
-  if (leakWatcherConfig.objectUniqueIDs.length > 0 &&
-      !leakWatcherConfig.objectUniqueIDs.includes(obj.__nativeId__Internal)) {
-      console.log(`The ID of the monitored object does not exist.`);
-      return true;
-  }
-  if (leakWatcherConfig.exclusionList.some(item => item.toLowerCase() === obj.constructor.name.toLowerCase()) &&
-      !leakWatcherConfig.objectUniqueIDs.includes(obj.__nativeId__Internal)) {
-    console.log(`Whitelist detection: ${leakWatcherConfig.exclusionList}`);
-    return true;
-  }
-  return false;
+function startGCtask(): void {
+  appState.currentLeakCount = jsLeakWatcherNative.snapshotLeakList();
+  ArkTools.forceFullGC();
+  appState.isGC = true;
 }
 
-function startGCtask(context): void {
-  appState.currentLeakList = getLeakList();
-  context.getRunningProcessInformation().then((data) => {
-    appState.processInformation = data;
-    appState.exists = appState.processInformation.find(item => item.processName === appState.bundleName);
-    if (appState.processInformation && appState.processInformation.length > 0 && appState.exists) {
-      appState.applicationState = appState.exists.state;
-      if (appState.currentLeakList.length < leakWatcherConfig.fgLeakCountThreshold &&
-          appState.applicationState === appState.stateForeground) {
-        appState.isGC = false;
-        console.log(`The number of startGCtask foreground leaks: ${(appState.currentLeakList.length)}` +
-                    ` is less than the threshold.`);
-        return;
-      }
+function updateAppState(state: number): void {
+  appState.applicationState = state;
+  jsLeakWatcherNative.setAppState(state);
+}
 
-      if (appState.currentLeakList.length < leakWatcherConfig.bgLeakCountThreshold &&
-          appState.applicationState === appState.stateBackground) {
-        appState.isGC = false;
-        console.log(`The number of startGCtask background leaks: ${(appState.currentLeakList.length)}` +
-                    ` is less than the threshold.`);
-        return;
-      }
-      ArkTools.forceFullGC();
-      appState.isGC = true;
+const applicationStateChangeCallback = {
+  onApplicationForeground() {
+    appState.isAppStateFromCallback = true;
+    updateAppState(appState.stateForeground);
+  },
+  onApplicationBackground() {
+    appState.isAppStateFromCallback = true;
+    updateAppState(appState.stateBackground);
+  }
+};
+
+function registerAppStateCallback(context): void {
+  if (appState.applicationContext === undefined) {
+    return;
+  }
+  try {
+    appState.applicationContext.on('applicationStateChange', applicationStateChangeCallback);
+  } catch (error) {
+    console.error(`registerAppStateCallback failed: ${JSON.stringify(error)}`);
+    return;
+  }
+  context.getRunningProcessInformation().then((data) => {
+    let exists = data.find(item => item.processName === appState.bundleName);
+    if (exists && !appState.isAppStateFromCallback) {
+      updateAppState(exists.state);
     }
   }).catch((error: BusinessError) => {
-    console.error(`startGCtask error: ${JSON.stringify(error)}`);
-    appState.isGC = false;
-    return;
+    console.error(`getRunningProcessInformation error: ${JSON.stringify(error)}`);
   });
 }
 
+function unregisterAppStateCallback(): void {
+  if (appState.applicationContext === undefined) {
+    return;
+  }
+  try {
+    appState.applicationContext.off('applicationStateChange', applicationStateChangeCallback);
+  } catch (error) {
+    console.error(`unregisterAppStateCallback failed: ${JSON.stringify(error)}`);
+  }
+}
+
+function updateGcRetryPending(): void {
+  jsLeakWatcherNative.setGcRetryPending(currentAttempt <= ATTEMPT_COUNT && retryMonitorObjectTypes !== undefined);
+}
+
 function startDumptask(filePath, callback): void {
   if (!appState.isGC) {
     console.log('startDumptask is not executed.');
     return;
   }
 
-  const isLengthEqual = appState.currentLeakList.length === appState.duplicateLeakList.length;
-  const hashEqual = isLengthEqual &&
-    appState.currentLeakList.every((item, index) => {
-      const isDuplicateLeakList = appState.duplicateLeakList[index];
-      if (!isDuplicateLeakList) {
-        return false;
-      }
-      if (item.hash === null || isDuplicateLeakList.hash === null) {
-        return false;
-      }
-      return item.hash === isDuplicateLeakList.hash;
-    });
-  if (hashEqual) {
+  const leakDiff = jsLeakWatcherNative.diffLeakList();
+  if (leakDiff.unchanged) {
     console.log("No new leakage objects were added.");
     return;
   }
-  appState.intersection = getLeakList().filter(item1 =>
-    appState.currentLeakList.some(item2 => item2.hash === item1.hash)
-  );
-  appState.duplicateLeakList = appState.intersection;
+  console.log(`Leak list diff, added: ${leakDiff.added}, removed: ${leakDiff.removed},` +
+              ` persistent: ${leakDiff.persistent}`);
+  appState.persistentLeakCount = leakDiff.persistent;
 
-  if (appState.processInformation && appState.processInformation.length > 0 && appState.exists) {
-    if (appState.intersection.length < leakWatcherConfig.fgLeakCountThreshold &&
-      appState.applicationState === appState.stateForeground) {
-      console.log(`The number of startDumptask foreground leaks: ${appState.intersection.length}` +
-                  ` is less than the threshold.`);
-      return;
-    }
+  if (appState.applicationState === stateUnknown) {
+    console.log('startDumptask is not executed, the application state is unknown.');
+    return;
+  }
+  if (appState.persistentLeakCount < leakWatcherConfig.fgLeakCountThreshold &&
+    appState.applicationState === appState.stateForeground) {
+    console.log(`The number of startDumptask foreground leaks: ${appState.persistentLeakCount}` +
+                ` is less than the threshold.`);
+    return;
+  }
 
-    if (appState.intersection.length < leakWatcherConfig.bgLeakCountThreshold &&
-        appState.applicationState === appState.stateBackground) {
-      console.log(`The number of startDumptask background leaks: ${appState.intersection.length}` +
-                  ` is less than the threshold.`);
-      return;
-    }
-    dumpInner(filePath, true, true, callback);
+  if (appState.persistentLeakCount < leakWatcherConfig.bgLeakCountThreshold &&
+      appState.applicationState === appState.stateBackground) {
+    console.log(`The number of startDumptask background leaks: ${appState.persistentLeakCount}` +
+                ` is less than the threshold.`);
+    return;
   }
+  dumpInner(filePath, true, true, callback);
 }
 
 function getLeakList() {
-  return Array.from(watchObjMap.values());
-}
-
-function getTimestampByFileName(fileName: string): number {
-  const regex = /(\d+)\.(heapsnapshot|jsleaklist|rawheap)/;
-  const fileMatch = fileName.match(regex);
-  return fileMatch ? parseInt(fileMatch[1]) : 0;
+  let leakList = [];
+  jsLeakWatcherNative.openLeakListIterator();
+  let batch = jsLeakWatcherNative.nextLeakListBatch(LEAK_LIST_BATCH_SIZE);
+  while (batch.length > 0) {
+    for (let i = 0; i < batch.length; i++) {
+      leakList.push(batch[i]);
+    }
+    batch = jsLeakWatcherNative.nextLeakListBatch(LEAK_LIST_BATCH_SIZE);
+  }
+  return leakList;
 }
 
 function getHeapPrefix(): string {
   return `jsleakwatcher-${process.pid}-${process.tid}-`;
 }
 
-function getHeapBaseName(update: boolean): string {
-  if (update) {
-    curTimeStamp = new Date().getTime().toString();
-  }
-  return `${getHeapPrefix()}${curTimeStamp}`;
+function getHeapBaseName(): string {
+  return `${getHeapPrefix()}${new Date().getTime().toString()}`;
 }
 
-function deleteLastOldFile(filePath: string): void {
-  let listFileOption = {
-    recursion: false,
-    listNum: 0,
-    filter: {
-      suffix: ['.jsleaklist'],
-    }
-  };
-  let files: string[];
-  try {
-    files = fs.listFileSync(filePath, listFileOption);
-  } catch (e) {
-    console.log('List files failed! ' + e);
-    return;
-  }
-  if (files.length <= 0) {
-    return;
-  }
-  files.sort((a, b) => {
-    return getTimestampByFileName(b) - getTimestampByFileName(a);
-  });
-  let prefix = getHeapPrefix();
-  if (!files[0].startsWith(prefix)) {
-    return;
-  }
-  let fileBaseName = prefix + getTimestampByFileName(files[0]);
-  try {
-    let jsleaklistPath = filePath + '/' + fileBaseName + '.jsleaklist';
-    if (fs.accessSync(jsleaklistPath)) {
-      fs.unlinkSync(jsleaklistPath);
-    }
-    let rawheapPath = filePath + '/' + fileBaseName + '.rawheap';
-    if (fs.accessSync(rawheapPath)) {
-      fs.unlinkSync(rawheapPath);
-    } else {
-      fs.unlinkSync(filePath + '/' + fileBaseName + '.heapsnapshot');
-    }
-  } catch (e) {
-    console.log('Delete files failed! ' + e);
-    return;
-  }
-  console.log(`delete same process heap files ${fileBaseName}`);
+function prepareDumpDir(filePath: string): void {
+  jsLeakWatcherNative.prepareDumpDir(filePath, getHeapPrefix(), firstDump);
+  firstDump = false;
 }
 
-function deleteUnMatchDumpFile(filePath: string): void {
-  let listFileOption = {
-    recursion: false,
-    listNum: 0,
-    filter: {
-      suffix: ['.rawheap'],
-    }
-  };
-  let files: string[];
-  try {
-    files = fs.listFileSync(filePath, listFileOption);
-  } catch (e) {
-    console.log('List files failed! ' + e);
-    return;
-  }
-  for (let i = 0; i < files.length; i++) {
-    let suffixOffset = files[i].lastIndexOf('.rawheap');
-    if (suffixOffset <= 0) {
-      continue;
-    }
-    let listFilePath = filePath + '/' + files[i].substring(0, suffixOffset) + '.jsleaklist';
-    if (!fs.accessSync(listFilePath, fs.AccessModeType.EXIST)) {
-      try {
-        fs.unlinkSync(filePath + '/' + files[i]);
-      } catch (e) {
-        console.log('Delete files failed! ' + e);
-        return;
-      }
-      console.warn(`delete ${files[i]} which no match jsleaklist`);
-    }
-  }
-}
-
-function createHeapDumpFile(filePath, isRawHeap, isSync, dumpCallback = undefined): void {
-  if (firstDump) {
-    firstDump = false;
-    deleteUnMatchDumpFile(filePath);
-  } else {
-    deleteLastOldFile(filePath);
-  }
-  let fileName = getHeapBaseName(true);
+function createHeapDumpFile(filePath, isRawHeap, isSync, dumpCallback = undefined): HeapDumpFile {
+  prepareDumpDir(filePath);
+  let fileName = getHeapBaseName();
   let suffix = isRawHeap ? '.rawheap' : '.heapsnapshot';
   let heapDumpFileName = fileName + suffix;
   let desFilePath = filePath + '/' + heapDumpFileName;
   if (isRawHeap) {
     if (!isSync) {
-      jsLeakWatcherNative.dumpRawHeap(desFilePath, dumpCallback);
-    } else {
-      jsLeakWatcherNative.dumpRawHeapSync(desFilePath, dumpCallback);
-    }
-  } else {
-    hidebug.dumpJsHeapData(fileName);
-    fs.moveFileSync(SANDBOX_PATH + heapDumpFileName, desFilePath, 0);
-  }
-}
-
-function getHeapDumpSHA256(filePath) {
-  let md = cryptoFramework.createMd('SHA256');
-  let heapDumpFile = fs.openSync(filePath, fs.OpenMode.READ_WRITE);
-  let bufSize = 40960;
-  let readSize = 0;
-  let buf = new ArrayBuffer(bufSize);
-  let readOptions = { offset: readSize, length: bufSize };
-  let readLen = fs.readSync(heapDumpFile.fd, buf, readOptions);
-
-  while (readLen > 0) {
-    md.updateSync({ data: new Uint8Array(buf.slice(0, readLen)) });
-    readSize += readLen;
-    readOptions.offset = readSize;
-    readLen = fs.readSync(heapDumpFile.fd, buf, readOptions);
-  }
-  fs.closeSync(heapDumpFile);
-
-  let digestOutPut = md.digestSync();
-  return Array.from(digestOutPut.data, byte => ('0' + byte.toString(16)).slice(-2)).join('').toUpperCase();
-}
-
-function deleteOldFile(filePath) {
-  let listFileOption = {
-    recursion: false,
-    listNum: 0,
-    filter: {
-      displayName: ['*.heapsnapshot', '*.jsleaklist', '*.rawheap'],
-    }
-  };
-  let files: string[];
-  try {
-    files = fs.listFileSync(filePath, listFileOption);
-  } catch (e) {
-    console.log('List files failed! ' + e);
-    return;
-  }
-  if (files.length > maxFileNum) {
-    files.sort((a, b) => {
-      return getTimestampByFileName(a) - getTimestampByFileName(b);
-    });
-    for (let i = 0; i < files.length - maxFileNum; i++) {
-      fs.unlinkSync(filePath + '/' + files[i]);
-      console.log(`File: ${files[i]} is deleted.`);
-      let timeStamp = getTimestampByFileName(files[i]).toString();
-      if (files[i + 1].includes(timeStamp)) {
-        fs.unlinkSync(filePath + '/' + files[i + 1]);
-        i++;
-      }
+      jsLeakWatcherNative.dumpRawHeap(desFilePath, (code, heapDumpSHA256) => {
+        dumpCallback(code, heapDumpSHA256, fileName);
+      });
+      return { baseName: fileName, sha256: '' };
     }
+    return { baseName: fileName, sha256: jsLeakWatcherNative.dumpRawHeapSync(desFilePath) };
   }
+  hidebug.dumpJsHeapData(fileName);
+  fs.moveFileSync(SANDBOX_PATH + heapDumpFileName, desFilePath, 0);
+  return { baseName: fileName, sha256: jsLeakWatcherNative.getHeapDumpSHA256(desFilePath) };
 }
 
 function registerObject(obj, msg) {
@@ -591,17 +447,17 @@ function registerObject(obj, msg) {
     return;
   }
 
-  let objMsg = { hash: util.getHash(obj), name: obj.constructor.name, msg: msg };
-  watchObjMap.set(objMsg.hash, objMsg);
-  registry.register(obj, objMsg.hash);
+  let hash = util.getHash(obj);
+  if (jsLeakWatcherNative.registerLeakObject(hash, obj.constructor.name, msg)) {
+    registry.register(obj, hash);
+  }
 }
 
 let lifecycleId;
 function registerAbilityLifecycleCallback() {
   let abilityLifecycleCallback = {
     onAbilityDestroy(ability) {
-      if (appState.isConfigObj &&
-        leakWatcherConfig.exclusionList.some(item => item.toLowerCase() === ability.name.toLowerCase())) {
+      if (appState.isConfigObj && jsLeakWatcherNative.isLeakNameExcluded(ability.name)) {
       } else {
         registerObject(ability, '');
       }
@@ -642,26 +498,14 @@ function executeRegister(config: MonitorObjectType) {
     });
   }
   if (config & MonitorObjectType.WINDOW) {
-    let ret = jsLeakWatcherNative.registerWindowLifeCycleCallback((obj) => {
-      if (appState.isConfigObj && leakWatcherConfig.exclusionList.some(
-        item => obj !== undefined && item.toLowerCase() === obj.getWindowProperties().name.toLowerCase())) {
-      } else {
-        registerObject(obj, '');
-      }
-    });
+    let ret = jsLeakWatcherNative.registerWindowLifeCycleNative();
     if (!ret) {
       retryMonitorObjectTypes = (retryMonitorObjectTypes === undefined) ? MonitorObjectType.WINDOW : retryMonitorObjectTypes | MonitorObjectType.WINDOW;
     }
   }
     if (config & MonitorObjectType.NODE_CONTAINER ||
         config & MonitorObjectType.X_COMPONENT) {
-    let ret = jsLeakWatcherNative.registerArkUIObjectLifeCycleCallback((weakRef) => {
-      if (!weakRef) {
-        return;
-      }
-      let obj = weakRef.deref();
-      registerObject(obj, '');
-    });
+    let ret = jsLeakWatcherNative.registerArkUIObjectLifeCycleNative();
     if (!ret) {
       retryMonitorObjectTypes = (retryMonitorObjectTypes === undefined) ? MonitorObjectType.NODE_CONTAINER : retryMonitorObjectTypes | MonitorObjectType.NODE_CONTAINER;
       retryMonitorObjectTypes = (retryMonitorObjectTypes === undefined) ? MonitorObjectType.WINDOW : retryMonitorObjectTypes | MonitorObjectType.X_COMPONENT;
@@ -681,40 +525,52 @@ function dumpInnerSync(filePath, needSandBox, isRawHeap) {
   if (!fs.accessSync(filePath, fs.AccessModeType.EXIST)) {
     throw new BusinessError(ERROR_CODE_INVALID_PARAM);
   }
+  let baseName = '';
   try {
-    createHeapDumpFile(filePath, isRawHeap, true);
-    let file = fs.openSync(filePath + '/' + getHeapBaseName(false) + '.jsleaklist', fs.OpenMode.READ_WRITE | fs.OpenMode.CREATE);
-    let leakObjList = getLeakList();
-    let suffix = isRawHeap ? '.rawheap' : '.heapsnapshot';
-    let heapDumpFileName = getHeapBaseName(false) + suffix;
-    let desFilePath = filePath + '/' + heapDumpFileName;
-    const heapDumpSHA256 = getHeapDumpSHA256(desFilePath);
-    if (isRawHeap) {
-      let result = { version: '2.0.0', snapshot_hash: heapDumpSHA256, leakObjList: leakObjList };
-      fs.writeSync(file.fd, JSON.stringify(result));
-    } else {
-      let result = { snapshot_hash: heapDumpSHA256, leakObjList: leakObjList };
-      fs.writeSync(file.fd, JSON.stringify(result));
-    }
-    fs.closeSync(file);
+    const heapDumpFile = createHeapDumpFile(filePath, isRawHeap, true);
+    baseName = heapDumpFile.baseName;
+    writeLeakListFile(filePath + '/' + baseName + '.jsleaklist', isRawHeap, heapDumpFile.sha256);
   } catch (error) {
     console.log('Dump heapSnapShot or LeakList failed! ' + error);
     return [];
   }
-
-  try {
-    deleteOldFile(filePath);
-  } catch (e) {
-    console.log('Delete old files failed! ' + e);
-    return [];
-  }
+  jsLeakWatcherNative.commitDump(filePath, baseName);
   if (needSandBox) {
-    return [filePath + '/' + getHeapBaseName(false) + '.jsleaklist', filePath + '/' + getHeapBaseName(false) + '.rawheap'];
+    return [filePath + '/' + baseName + '.jsleaklist', filePath + '/' + baseName + '.rawheap'];
   } else {
-    return [getHeapBaseName(false) + '.jsleaklist', getHeapBaseName(false) + '.heapsnapshot'];
+    return [baseName + '.jsleaklist', baseName + '.heapsnapshot'];
   }
 }
 
+function getEmptyDumpResult(): DumpResult {
+  return { leakListPath: '', rawHeapPath: '', fileSize: 0, sha256: '' };
+}
+
+function dumpInnerAsync(filePath): Promise<DumpResult> {
+  if (!enabled) {
+    return Promise.resolve(getEmptyDumpResult());
+  }
+  if (!fs.accessSync(filePath, fs.AccessModeType.EXIST)) {
+    throw new BusinessError(ERROR_CODE_INVALID_PARAM);
+  }
+  prepareDumpDir(filePath);
+  let baseName = getHeapBaseName();
+  return jsLeakWatcherNative.dumpRawHeapAsync(filePath + '/' + baseName + '.rawheap').then((dumpResult) => {
+    const leakListPath = filePath + '/' + baseName + '.jsleaklist';
+    writeLeakListFile(leakListPath, true, dumpResult.sha256);
+    jsLeakWatcherNative.commitDump(filePath, baseName);
+    return {
+      leakListPath: leakListPath,
+      rawHeapPath: dumpResult.rawHeapPath,
+      fileSize: dumpResult.fileSize,
+      sha256: dumpResult.sha256
+    };
+  }).catch((error) => {
+    console.log('Dump rawheap or LeakList failed! ' + error);
+    return getEmptyDumpResult();
+  });
+}
+
 function dumpInner(filePath, needSandBox, isRawHeap, jsCallback: Callback<Array<string>> = undefined) {
   dumpStatus = jsLeakWatcherNative.getDumpStatus();
   if (!enabled) {
@@ -724,13 +580,14 @@ function dumpInner(filePath, needSandBox, isRawHeap, jsCallback: Callback<Array<
     throw new BusinessError(ERROR_CODE_INVALID_PARAM);
   }
   if (!dumpStatus) {
-    getJsleaklistFile(filePath, needSandBox, isRawHeap, jsCallback);
+    prepareDumpDir(filePath);
+    getJsleaklistFile(filePath, getHeapBaseName(), needSandBox, isRawHeap, jsCallback);
     return [];
   }
   try {
-    createHeapDumpFile(filePath, isRawHeap, false, (code) => {
+    createHeapDumpFile(filePath, isRawHeap, false, (code, heapDumpSHA256, baseName) => {
       console.log('createHeapDumpFile begin!');
-      getJsleaklistFile(filePath, needSandBox, isRawHeap, jsCallback);
+      getJsleaklistFile(filePath, baseName, needSandBox, isRawHeap, jsCallback, heapDumpSHA256);
       return [];
     });
   } catch (error) {
@@ -745,13 +602,15 @@ function shutdownJsLeakWatcher() {
   jsLeakWatcherNative.unregisterWindowLifeCycleCallback();
   unregisterArkUIObjectLifeCycleCallback();
   unregisterAbilityLifecycleCallback();
-  watchObjMap.clear();
+  unregisterAppStateCallback();
+  jsLeakWatcherNative.clearLeakObjects();
 }
 
 let jsLeakWatcher = {
   MonitorObjectType: MonitorObjectType,
   LeakWatcherConfig: {} as LeakWatcherConfig,
   watch: (obj, msg) => {
+    initModule();
     jsLeakWatcherNative.apiRecord('watch');
     if (obj === undefined || obj === null || msg === undefined || msg === null) {
       throw new BusinessError(ERROR_CODE_INVALID_PARAM);
@@ -759,11 +618,10 @@ let jsLeakWatcher = {
     if (!enabled) {
       return;
     }
-    let objMsg = { hash: util.getHash(obj), name: obj.constructor.name, msg: msg };
-    watchObjMap.set(objMsg.hash, objMsg);
-    registry.register(obj, objMsg.hash);
+    registerObject(obj, msg);
   },
   check: () => {
+    initModule();
     jsLeakWatcherNative.apiRecord('check');
     if (!enabled) {
       return '';
@@ -772,23 +630,34 @@ let jsLeakWatcher = {
     return JSON.stringify(leakObjList);
   },
   dump: (filePath) => {
+    initModule();
     jsLeakWatcherNative.apiRecord('dump');
     if (filePath === undefined || filePath === null) {
       throw new BusinessError(ERROR_CODE_INVALID_PARAM);
     }
     return dumpInnerSync(filePath, false, false);
   },
+  dumpAsync: (filePath): Promise<DumpResult> => {
+    initModule();
+    jsLeakWatcherNative.apiRecord('dumpAsync');
+    if (filePath === undefined || filePath === null) {
+      throw new BusinessError(ERROR_CODE_INVALID_PARAM);
+    }
+    return dumpInnerAsync(filePath);
+  },
   enable: (isEnable) => {
+    initModule();
     jsLeakWatcherNative.apiRecord('enable');
     if (isEnable === undefined || isEnable === null) {
       throw new BusinessError(ERROR_CODE_INVALID_PARAM);
     }
     enabled = isEnable;
     if (!isEnable) {
-      watchObjMap.clear();
+      jsLeakWatcherNative.clearLeakObjects();
     }
   },
   enableLeakWatcher: (isEnabled: boolean, configs: Array<string> | LeakWatcherConfig, callback: Callback<Array<string>>) => {
+    initModule();
     if (isEnabled === undefined || isEnabled === null) {
       throw new BusinessError(ERROR_CODE_ENABLE_INVALID);
     }
@@ -841,9 +710,10 @@ let jsLeakWatcher = {
       if (currentAttempt <= ATTEMPT_COUNT && retryMonitorObjectTypes !== undefined) {
         executeRegister(retryMonitorObjectTypes);
         currentAttempt += 1;
+        updateGcRetryPending();
       }
       if (appState.isConfigObj) {
-        startGCtask(context);
+        startGCtask();
       } else {
         ArkTools.forceFullGC();
       }
@@ -852,7 +722,7 @@ let jsLeakWatcher = {
       if (appState.isConfigObj) {
         startDumptask(filePath, callback);
       } else {
-        if (watchObjMap.size === 0) {
+        if (jsLeakWatcherNative.getLeakObjectCount() === 0) {
           console.log('No js leak detected, no need to dump.');
           return;
         }
@@ -867,6 +737,10 @@ let jsLeakWatcher = {
       leakWatcherConfig.monitorObjectTypes = convertToMask(configArray);
     }
     executeRegister(leakWatcherConfig.monitorObjectTypes);
+    updateGcRetryPending();
+    if (appState.isConfigObj) {
+      registerAppStateCallback(context);
+    }
   }
 };
 
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_delta.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "hilog/log.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD003D00
+#undef LOG_TAG
+#define LOG_TAG "JSLEAK_WATCHER_C"
+
+namespace {
+constexpr uint64_t DELTA_FDTAG = 0xD002D0B;
+constexpr uint32_t MIN_CHUNK_SIZE = 16 * 1024;
+constexpr uint32_t MAX_CHUNK_SIZE = 256 * 1024;
+constexpr uint64_t CHUNK_BOUNDARY_MASK = (1ULL << 16) - 1; // 64KB chunks on average
+constexpr size_t READ_BUFFER_SIZE = 4 * MAX_CHUNK_SIZE;
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+constexpr uint64_t GEAR_SEED = 0x9E3779B97F4A7C15ULL;
+constexpr int SPLITMIX_SHIFT_A = 30;
+constexpr int SPLITMIX_SHIFT_B = 27;
+constexpr int SPLITMIX_SHIFT_C = 31;
+constexpr uint64_t SPLITMIX_MUL_A = 0xBF58476D1CE4E5B9ULL;
+constexpr uint64_t SPLITMIX_MUL_B = 0x94D049BB133111EBULL;
+constexpr size_t GEAR_TABLE_SIZE = 256;
+constexpr uint64_t MIN_MATCH_DIVISOR = 2;
+
+using ChunkVisitor = std::function<bool(const char* data, uint32_t size, uint64_t offset)>;
+
+const std::array<uint64_t, GEAR_TABLE_SIZE>& GetGearTable()
+{
+    static const std::array<uint64_t, GEAR_TABLE_SIZE> table = [] {
+        std::array<uint64_t, GEAR_TABLE_SIZE> gear {};
+        uint64_t state = 0;
+        for (auto& value : gear) {
+            state += GEAR_SEED;
+            uint64_t z = state;
+            z = (z ^ (z >> SPLITMIX_SHIFT_A)) * SPLITMIX_MUL_A;
+            z = (z ^ (z >> SPLITMIX_SHIFT_B)) * SPLITMIX_MUL_B;
+            value = z ^ (z >> SPLITMIX_SHIFT_C);
+        }
+        return gear;
+    }();
+    return table;
+}
+
+uint64_t Fnv1a64(const char* data, uint32_t size)
+{
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+uint32_t FindChunkEnd(const char* data, uint32_t available)
+{
+    if (available <= MIN_CHUNK_SIZE) {
+        return available;
+    }
+    const auto& gear = GetGearTable();
+    uint32_t limit = available < MAX_CHUNK_SIZE ? available : MAX_CHUNK_SIZE;
+    uint64_t hash = 0;
+    for (uint32_t i = MIN_CHUNK_SIZE; i < limit; i++) {
+        hash = (hash << 1) + gear[static_cast<uint8_t>(data[i])];
+        if ((hash & CHUNK_BOUNDARY_MASK) == 0) {
+            return i + 1;
+        }
+    }
+    return limit;
+}
+
+bool ReadSome(int fd, char* buff, size_t size, off_t offset, size_t& done)
+{
+    done = 0;
+    while (done < size) {
+        ssize_t ret = pread(fd, buff + done, size - done, offset + static_cast<off_t>(done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret < 0) {
+            return false;
+        }
+        if (ret == 0) {
+            break;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+/* content defined chunking over the first size bytes of fd, a chunk never crosses the read buffer */
+bool ForEachChunk(int fd, uint64_t size, const ChunkVisitor& visitor)
+{
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    uint64_t fileOffset = 0;
+    size_t begin = 0;
+    size_t end = 0;
+    while (fileOffset + begin < size) {
+        if (end - begin < MAX_CHUNK_SIZE && fileOffset + end < size) {
+            memmove(buffer.data(), buffer.data() + begin, end - begin);
+            fileOffset += begin;
+            end -= begin;
+            begin = 0;
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(buffer.size() - end, size - fileOffset - end));
+            size_t done = 0;
+            if (!ReadSome(fd, buffer.data() + end, wanted, static_cast<off_t>(fileOffset + end), done) ||
+                done != wanted) {
+                return false;
+            }
+            end += done;
+        }
+        uint32_t chunkSize = FindChunkEnd(buffer.data() + begin, static_cast<uint32_t>(end - begin));
+        if (!visitor(buffer.data() + begin, chunkSize, fileOffset + begin)) {
+            return false;
+        }
+        begin += chunkSize;
+    }
+    return true;
+}
+
+bool WriteAll(int fd, const void* buff, size_t size, uint64_t& offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = pwrite(fd, static_cast<const char*>(buff) + done, size - done,
+            static_cast<off_t>(offset + done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    offset += size;
+    return true;
+}
+
+std::string GetFileName(const std::string& path)
+{
+    size_t pos = path.find_last_of('/');
+    return pos == std::string::npos ? path : path.substr(pos + 1);
+}
+}
+
+void RawHeapDeltaEncoder::SetRebaseInterval(uint32_t interval)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    rebaseInterval_ = interval;
+}
+
+std::string RawHeapDeltaEncoder::GetBasePath()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return basePath_;
+}
+
+void RawHeapDeltaEncoder::Reset()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    basePath_.clear();
+    baseChunks_.clear();
+    deltaCount_ = 0;
+}
+
+bool RawHeapDeltaEncoder::IndexBase(int fd, uint64_t size, const std::string& filePath)
+{
+    baseChunks_.clear();
+    bool ret = ForEachChunk(fd, size, [this](const char* data, uint32_t chunkSize, uint64_t offset) {
+        baseChunks_.emplace(Fnv1a64(data, chunkSize), BaseChunk { offset, chunkSize });
+        return true;
+    });
+    basePath_ = ret ? filePath : "";
+    deltaCount_ = 0;
+    return ret;
+}
+
+bool RawHeapDeltaEncoder::WriteDelta(int srcFd, uint64_t size, int dstFd, const std::string& baseName,
+    uint64_t& newBytes)
+{
+    std::vector<RawHeapDeltaChunk> recipe;
+    uint64_t writeOffset = 0;
+    bool ret = ForEachChunk(srcFd, size, [&](const char* data, uint32_t chunkSize, uint64_t) {
+        uint64_t hash = Fnv1a64(data, chunkSize);
+        auto iter = baseChunks_.find(hash);
+        if (iter != baseChunks_.end() && iter->second.size == chunkSize) {
+            recipe.push_back({ hash, iter->second.offset, chunkSize, DELTA_SOURCE_BASE });
+            return true;
+        }
+        recipe.push_back({ hash, writeOffset, chunkSize, DELTA_SOURCE_SELF });
+        return WriteAll(dstFd, data, chunkSize, writeOffset);
+    });
+    if (!ret) {
+        return false;
+    }
+    newBytes = writeOffset;
+    RawHeapDeltaTrailer trailer = { RAWHEAP_DELTA_MAGIC, RAWHEAP_DELTA_VERSION, static_cast<uint32_t>(recipe.size()),
+        static_cast<uint32_t>(baseName.size()), size, 0 };
+    if (!WriteAll(dstFd, baseName.data(), baseName.size(), writeOffset)) {
+        return false;
+    }
+    trailer.recipeOffset = writeOffset;
+    return WriteAll(dstFd, recipe.data(), recipe.size() * sizeof(RawHeapDeltaChunk), writeOffset) &&
+        WriteAll(dstFd, &trailer, sizeof(trailer), writeOffset);
+}
+
+bool RawHeapDeltaEncoder::Encode(const std::string& filePath, bool& isBase, std::string& basePath)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    isBase = false;
+    basePath.clear();
+    int srcFd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (srcFd < 0) {
+        return false;
+    }
+    fdsan_exchange_owner_tag(srcFd, 0, DELTA_FDTAG);
+    struct stat st;
+    if (fstat(srcFd, &st) != 0) {
+        fdsan_close_with_tag(srcFd, DELTA_FDTAG);
+        return false;
+    }
+    auto size = static_cast<uint64_t>(st.st_size);
+    bool rebase = basePath_.empty() || deltaCount_ + 1 >= rebaseInterval_ || access(basePath_.c_str(), F_OK) != 0;
+    if (!rebase) {
+        std::string tmpPath = filePath + ".tmp";
+        int dstFd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & (S_IRWXU | S_IRWXG));
+        uint64_t newBytes = 0;
+        bool written = false;
+        if (dstFd >= 0) {
+            fdsan_exchange_owner_tag(dstFd, 0, DELTA_FDTAG);
+            written = WriteDelta(srcFd, size, dstFd, GetFileName(basePath_), newBytes);
+            fdsan_close_with_tag(dstFd, DELTA_FDTAG);
+        }
+        // mostly new content is cheaper to keep whole, and it makes a better base for the next dumps
+        if (written && newBytes * MIN_MATCH_DIVISOR <= size && rename(tmpPath.c_str(), filePath.c_str()) == 0) {
+            deltaCount_++;
+            basePath = basePath_;
+            fdsan_close_with_tag(srcFd, DELTA_FDTAG);
+            return true;
+        }
+        unlink(tmpPath.c_str());
+    }
+    isBase = IndexBase(srcFd, size, filePath);
+    fdsan_close_with_tag(srcFd, DELTA_FDTAG);
+    if (!isBase) {
+        HILOG_ERROR(LOG_CORE, "index delta base failed, errno: %{public}d", errno);
+    }
+    basePath = basePath_;
+    return isBase;
+}
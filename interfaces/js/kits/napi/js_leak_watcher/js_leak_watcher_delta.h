@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_DELTA_H
+#define JS_LEAK_WATCHER_DELTA_H
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+ * A delta rawheap body is [new chunk bytes][base file name][RawHeapDeltaChunk...][RawHeapDeltaTrailer].
+ * The recipe lists the chunks of the full body in order, each one either copied from the base rawheap in
+ * the same directory or stored in this file. Chunk boundaries depend on the content only, so objects that
+ * moved between two dumps still match.
+ */
+struct RawHeapDeltaChunk {
+    uint64_t hash;
+    uint64_t offset;
+    uint32_t size;
+    uint32_t source;
+};
+static_assert(sizeof(RawHeapDeltaChunk) == 24, "RawHeapDeltaChunk is part of the rawheap format");
+
+struct RawHeapDeltaTrailer {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t chunkCount;
+    uint32_t baseNameSize;
+    uint64_t rawSize;
+    uint64_t recipeOffset;
+};
+static_assert(sizeof(RawHeapDeltaTrailer) == 32, "RawHeapDeltaTrailer is part of the rawheap format");
+
+constexpr uint32_t RAWHEAP_DELTA_MAGIC = 0x4C444C4A; // "JLDL"
+constexpr uint32_t RAWHEAP_DELTA_VERSION = 1;
+constexpr uint32_t DELTA_SOURCE_BASE = 0;
+constexpr uint32_t DELTA_SOURCE_SELF = 1;
+constexpr uint32_t DEFAULT_DELTA_REBASE_INTERVAL = 8;
+
+/*
+ * Turns consecutive dumps into deltas against the last full one. The chunk index of the base is kept in
+ * memory, so encoding reads only the new dump. A dump becomes the new base when there is none yet, the
+ * base file is gone, rebaseInterval deltas have been written, or less than half of it matches the base.
+ */
+class RawHeapDeltaEncoder {
+public:
+    void SetRebaseInterval(uint32_t interval);
+    /*
+     * must run before compression and metadata, isBase tells whether the file was kept as a full dump,
+     * basePath is the base the file now depends on, the file itself when it became the base
+     */
+    bool Encode(const std::string& filePath, bool& isBase, std::string& basePath);
+    std::string GetBasePath();
+    void Reset();
+
+private:
+    struct BaseChunk {
+        uint64_t offset;
+        uint32_t size;
+    };
+
+    bool IndexBase(int fd, uint64_t size, const std::string& filePath);
+    bool WriteDelta(int srcFd, uint64_t size, int dstFd, const std::string& baseName, uint64_t& newBytes);
+
+    std::mutex lock_;
+    std::string basePath_;
+    std::unordered_map<uint64_t, BaseChunk> baseChunks_;
+    uint32_t deltaCount_ = 0;
+    uint32_t rebaseInterval_ = DEFAULT_DELTA_REBASE_INTERVAL;
+};
+#endif // JS_LEAK_WATCHER_DELTA_H
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_dump_pool.h"
+
+#include "securec.h"
+
+bool DumpRequestSlot::SetFilePath(const std::string& path)
+{
+    if (strcpy_s(filePath, sizeof(filePath), path.c_str()) != EOK) {
+        filePath[0] = '\0';
+        return false;
+    }
+    return true;
+}
+
+DumpRequestSlot* DumpRequestPool::Acquire(void* callback)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    for (uint32_t i = 0; i < DUMP_REQUEST_SLOT_COUNT; i++) {
+        if (used_[i]) {
+            continue;
+        }
+        used_[i] = true;
+        DumpRequestSlot& slot = slots_[i];
+        slot.requestId = nextRequestId_++;
+        if (nextRequestId_ == 0) {
+            nextRequestId_ = 1;
+        }
+        slot.retcode = 0;
+        slot.digest[0] = '\0';
+        slot.callback = callback;
+        slot.deferred = nullptr;
+        slot.env = nullptr;
+        slot.channelId = 0;
+        slot.filePath[0] = '\0';
+        slot.fileSize = 0;
+        return &slot;
+    }
+    return nullptr;
+}
+
+void DumpRequestPool::Release(DumpRequestSlot* slot)
+{
+    if (slot == nullptr || slot < slots_ || slot >= slots_ + DUMP_REQUEST_SLOT_COUNT) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(lock_);
+    slot->callback = nullptr;
+    slot->deferred = nullptr;
+    used_[slot - slots_] = false;
+}
+
+uint32_t DumpRequestPool::GetPendingCount()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    uint32_t count = 0;
+    for (bool used : used_) {
+        count += used ? 1 : 0;
+    }
+    return count;
+}
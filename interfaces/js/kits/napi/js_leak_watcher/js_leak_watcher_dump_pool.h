@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_DUMP_POOL_H
+#define JS_LEAK_WATCHER_DUMP_POOL_H
+#include <climits>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+constexpr uint32_t DUMP_REQUEST_SLOT_COUNT = 4;
+constexpr size_t DUMP_DIGEST_BUFFER_SIZE = 65; // SHA-256 in hex and the terminator
+
+struct DumpRequestSlot {
+    uint32_t requestId = 0;
+    uint8_t retcode = 0;
+    /* empty when the rawheap could not be finished */
+    char digest[DUMP_DIGEST_BUFFER_SIZE] = {0};
+    /* owned by the JS thread that started the dump, opaque to the pool */
+    void* callback = nullptr;
+    /* set instead of callback when the dump was started by the promise variant */
+    void* deferred = nullptr;
+    /* env and generation of the completion channel the dump acquired, opaque to the pool */
+    void* env = nullptr;
+    uint64_t channelId = 0;
+    char filePath[PATH_MAX] = {0};
+    uint64_t fileSize = 0;
+
+    /* false when the path does not fit, the slot then keeps an empty path */
+    bool SetFilePath(const std::string& path);
+};
+
+/*
+ * Fixed set of slots for the rawheap dumps in flight. A slot is taken on the JS thread when a dump starts,
+ * filled by the thread that finishes the dump and handed back to the JS thread as the threadsafe function
+ * data, so a completion neither allocates nor needs a threadsafe function of its own. Path and digest live
+ * in fixed buffers of the slot.
+ */
+class DumpRequestPool {
+public:
+    /* nullptr when every slot has a dump in flight */
+    DumpRequestSlot* Acquire(void* callback);
+    void Release(DumpRequestSlot* slot);
+    uint32_t GetPendingCount();
+
+private:
+    std::mutex lock_;
+    DumpRequestSlot slots_[DUMP_REQUEST_SLOT_COUNT];
+    bool used_[DUMP_REQUEST_SLOT_COUNT] = {false};
+    uint32_t nextRequestId_ = 1;
+};
+#endif // JS_LEAK_WATCHER_DUMP_POOL_H
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_filter.h"
+
+namespace {
+constexpr size_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr size_t FNV_PRIME = 1099511628211ULL;
+
+inline char FoldCase(char ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+}
+
+size_t LeakWatcherFilter::FoldedHash::operator()(std::string_view str) const
+{
+    size_t hash = FNV_OFFSET_BASIS;
+    for (char ch : str) {
+        hash = (hash ^ static_cast<unsigned char>(FoldCase(ch))) * FNV_PRIME;
+    }
+    return hash;
+}
+
+bool LeakWatcherFilter::FoldedEqual::operator()(std::string_view lhs, std::string_view rhs) const
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.size(); i++) {
+        if (FoldCase(lhs[i]) != FoldCase(rhs[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void LeakWatcherFilter::SetExclusionList(const std::vector<std::string>& exclusionList)
+{
+    exclusionSet_.clear();
+    exclusionNames_ = exclusionList;
+    exclusionSet_.reserve(exclusionNames_.size());
+    for (const auto& name : exclusionNames_) {
+        exclusionSet_.insert(std::string_view(name));
+    }
+}
+
+void LeakWatcherFilter::SetObjectIds(const std::vector<int64_t>& objectIds)
+{
+    objectIds_.clear();
+    objectIds_.insert(objectIds.begin(), objectIds.end());
+}
+
+void LeakWatcherFilter::Clear()
+{
+    exclusionSet_.clear();
+    exclusionNames_.clear();
+    objectIds_.clear();
+}
+
+bool LeakWatcherFilter::HasObjectIds() const
+{
+    return !objectIds_.empty();
+}
+
+bool LeakWatcherFilter::IsNameExcluded(std::string_view name) const
+{
+    return !exclusionSet_.empty() && exclusionSet_.find(name) != exclusionSet_.end();
+}
+
+bool LeakWatcherFilter::IsIdMonitored(bool hasId, int64_t id) const
+{
+    return hasId && objectIds_.find(id) != objectIds_.end();
+}
+
+bool LeakWatcherFilter::IsObjectFiltered(std::string_view name, bool hasId, int64_t id) const
+{
+    return !IsIdMonitored(hasId, id) && (HasObjectIds() || IsNameExcluded(name));
+}
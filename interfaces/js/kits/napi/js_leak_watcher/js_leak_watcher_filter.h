@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_FILTER_H
+#define JS_LEAK_WATCHER_FILTER_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/*
+ * Exclusion list and monitored object IDs of the leak watcher config, compiled once when the config is
+ * set. Names are compared ASCII case-insensitively through a folding hash, so a lookup neither lowers
+ * the name nor allocates.
+ */
+class LeakWatcherFilter {
+public:
+    void SetExclusionList(const std::vector<std::string>& exclusionList);
+    void SetObjectIds(const std::vector<int64_t>& objectIds);
+    void Clear();
+    bool HasObjectIds() const;
+    bool IsNameExcluded(std::string_view name) const;
+    bool IsIdMonitored(bool hasId, int64_t id) const;
+    /* same decision as the former monitorLeakIDandWhitelist: true means the object is not watched */
+    bool IsObjectFiltered(std::string_view name, bool hasId, int64_t id) const;
+
+private:
+    struct FoldedHash {
+        size_t operator()(std::string_view str) const;
+    };
+    struct FoldedEqual {
+        bool operator()(std::string_view lhs, std::string_view rhs) const;
+    };
+
+    std::vector<std::string> exclusionNames_;
+    std::unordered_set<std::string_view, FoldedHash, FoldedEqual> exclusionSet_;
+    std::unordered_set<int64_t> objectIds_;
+};
+#endif // JS_LEAK_WATCHER_FILTER_H
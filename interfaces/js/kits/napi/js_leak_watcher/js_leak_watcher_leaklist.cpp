@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_leaklist.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <unistd.h>
+
+namespace {
+constexpr char HEX_DIGITS[] = "0123456789abcdef";
+constexpr unsigned char FIRST_PRINTABLE = 0x20;
+constexpr int HIGH_NIBBLE_SHIFT = 4;
+constexpr unsigned char NIBBLE_MASK = 0xF;
+constexpr uint64_t LEAKLIST_FDTAG = 0xD002D0B;
+
+const char* GetEscape(unsigned char ch)
+{
+    switch (ch) {
+        case '"':
+            return "\\\"";
+        case '\\':
+            return "\\\\";
+        case '\b':
+            return "\\b";
+        case '\f':
+            return "\\f";
+        case '\n':
+            return "\\n";
+        case '\r':
+            return "\\r";
+        case '\t':
+            return "\\t";
+        default:
+            return nullptr;
+    }
+}
+
+bool WriteAll(int fd, const char* data, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = write(fd, data + done, size - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, char* data, size_t size)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = read(fd, data + done, size - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+/* interns the strings of one file, the string table is laid out in first use order */
+class StringTable {
+public:
+    uint32_t Intern(std::string_view str)
+    {
+        auto iter = index_.find(str);
+        if (iter != index_.end()) {
+            return iter->second;
+        }
+        uint32_t id = count_++;
+        index_.emplace(str, id);
+        uint32_t length = static_cast<uint32_t>(str.size());
+        data_.append(reinterpret_cast<const char*>(&length), sizeof(length));
+        data_.append(str);
+        return id;
+    }
+    uint32_t Count() const
+    {
+        return count_;
+    }
+    const std::string& Data() const
+    {
+        return data_;
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> index_;
+    std::string data_;
+    uint32_t count_ = 0;
+};
+}
+
+LeakListWriter::LeakListWriter(int fd) : fd_(fd), buffer_(LEAK_LIST_WRITE_BUFFER_SIZE) {}
+
+LeakListWriter::LeakListWriter(std::string& out) : out_(&out) {}
+
+bool LeakListWriter::Flush()
+{
+    size_t done = 0;
+    while (done < used_ && !failed_) {
+        ssize_t ret = write(fd_, buffer_.data() + done, used_ - done);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            failed_ = true;
+            break;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    used_ = 0;
+    return !failed_;
+}
+
+void LeakListWriter::Append(std::string_view str)
+{
+    written_ += str.size();
+    if (out_ != nullptr) {
+        out_->append(str);
+        return;
+    }
+    while (!str.empty()) {
+        if (used_ == buffer_.size() && !Flush()) {
+            return;
+        }
+        size_t len = std::min(str.size(), buffer_.size() - used_);
+        std::copy(str.data(), str.data() + len, buffer_.data() + used_);
+        used_ += len;
+        str.remove_prefix(len);
+    }
+}
+
+/* quotes and escapes like JSON.stringify, other bytes of the UTF-8 text are kept as they are */
+void LeakListWriter::AppendString(std::string_view str)
+{
+    Append("\"");
+    size_t begin = 0;
+    for (size_t i = 0; i < str.size(); i++) {
+        auto ch = static_cast<unsigned char>(str[i]);
+        const char* escaped = GetEscape(ch);
+        if (escaped == nullptr && ch >= FIRST_PRINTABLE) {
+            continue;
+        }
+        Append(str.substr(begin, i - begin));
+        begin = i + 1;
+        if (escaped != nullptr) {
+            Append(escaped);
+            continue;
+        }
+        char unicode[] = { '\\', 'u', '0', '0', HEX_DIGITS[ch >> HIGH_NIBBLE_SHIFT], HEX_DIGITS[ch & NIBBLE_MASK] };
+        Append(std::string_view(unicode, sizeof(unicode)));
+    }
+    Append(str.substr(begin));
+    Append("\"");
+}
+
+void LeakListWriter::Begin(std::string_view version, std::string_view snapshotHash)
+{
+    Append("{");
+    if (!version.empty()) {
+        Append("\"version\":");
+        AppendString(version);
+        Append(",");
+    }
+    Append("\"snapshot_hash\":");
+    AppendString(snapshotHash);
+    Append(",\"leakObjList\":");
+    BeginArray();
+}
+
+void LeakListWriter::BeginArray()
+{
+    Append("[");
+    first_ = true;
+}
+
+void LeakListWriter::Add(uint32_t hash, std::string_view name, std::string_view msg)
+{
+    Append(first_ ? "{\"hash\":" : ",{\"hash\":");
+    first_ = false;
+    // JS has always seen the hash as a signed 32-bit integer
+    Append(std::to_string(static_cast<int32_t>(hash)));
+    Append(",\"name\":");
+    AppendString(name);
+    Append(",\"msg\":");
+    AppendString(msg);
+    Append("}");
+}
+
+void LeakListWriter::AddClassCount(std::string_view name, uint32_t count)
+{
+    Append(first_ ? "{\"name\":" : ",{\"name\":");
+    first_ = false;
+    AppendString(name);
+    Append(",\"count\":");
+    Append(std::to_string(count));
+    Append("}");
+}
+
+void LeakListWriter::EndArray()
+{
+    Append("]");
+}
+
+bool LeakListWriter::End()
+{
+    EndArray();
+    Append("}");
+    return out_ != nullptr || Flush();
+}
+
+uint64_t LeakListWriter::GetWrittenSize() const
+{
+    return written_;
+}
+
+uint32_t WriteLeakObjects(LeakListWriter& writer, const LeakObjectRegistry& registry,
+    const std::vector<uint32_t>* hashes)
+{
+    uint32_t count = 0;
+    auto add = [&writer, &registry, &count](const LeakObjectInfo& info) {
+        writer.Add(info.hash, registry.GetString(info.nameId), registry.GetString(info.msgId));
+        count++;
+    };
+    if (hashes == nullptr) {
+        registry.ForEach(add);
+        return count;
+    }
+    LeakObjectInfo info;
+    for (uint32_t hash : *hashes) {
+        if (registry.Find(hash, info)) {
+            add(info);
+        }
+    }
+    return count;
+}
+
+bool WriteBinaryLeakList(int fd, const LeakObjectRegistry& registry, std::string_view version,
+    std::string_view snapshotHash, uint64_t& size)
+{
+    // the views stay valid because the registry is not modified while the table is built
+    StringTable strings;
+    LeakListBinaryHeader header;
+    if (!version.empty()) {
+        header.versionIndex = strings.Intern(version);
+    }
+    header.snapshotHashIndex = strings.Intern(snapshotHash);
+    std::vector<LeakListBinaryRecord> records;
+    records.reserve(registry.Size());
+    registry.ForEach([&records, &strings, &registry](const LeakObjectInfo& info) {
+        LeakListBinaryRecord record;
+        record.timestamp = info.timestamp;
+        record.hash = info.hash;
+        record.nameIndex = strings.Intern(registry.GetString(info.nameId));
+        record.msgIndex = strings.Intern(registry.GetString(info.msgId));
+        records.push_back(record);
+    });
+    header.stringCount = strings.Count();
+    header.recordCount = static_cast<uint32_t>(records.size());
+    size_t recordBytes = records.size() * sizeof(LeakListBinaryRecord);
+    if (!WriteAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) ||
+        !WriteAll(fd, strings.Data().data(), strings.Data().size()) ||
+        !WriteAll(fd, reinterpret_cast<const char*>(records.data()), recordBytes)) {
+        return false;
+    }
+    size = sizeof(header) + strings.Data().size() + recordBytes;
+    return true;
+}
+
+/* every count and length in the file is checked against the bytes left before anything is allocated for it */
+static bool ReadBinaryLeakListFromFd(int fd, BinaryLeakList& list)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(LeakListBinaryHeader))) {
+        return false;
+    }
+    uint64_t remaining = static_cast<uint64_t>(st.st_size) - sizeof(LeakListBinaryHeader);
+    LeakListBinaryHeader& header = list.header;
+    if (!ReadAll(fd, reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != LEAK_LIST_BINARY_MAGIC ||
+        header.version != LEAK_LIST_BINARY_VERSION) {
+        return false;
+    }
+    if (static_cast<uint64_t>(header.stringCount) * sizeof(uint32_t) > remaining) {
+        return false;
+    }
+    list.strings.clear();
+    list.strings.reserve(header.stringCount);
+    for (uint32_t i = 0; i < header.stringCount; i++) {
+        uint32_t length = 0;
+        if (remaining < sizeof(length) || !ReadAll(fd, reinterpret_cast<char*>(&length), sizeof(length))) {
+            return false;
+        }
+        remaining -= sizeof(length);
+        if (length > remaining) {
+            return false;
+        }
+        std::string str(length, '\0');
+        if (!ReadAll(fd, str.data(), length)) {
+            return false;
+        }
+        remaining -= length;
+        list.strings.push_back(std::move(str));
+    }
+    if (static_cast<uint64_t>(header.recordCount) * sizeof(LeakListBinaryRecord) > remaining) {
+        return false;
+    }
+    list.records.resize(header.recordCount);
+    if (!ReadAll(fd, reinterpret_cast<char*>(list.records.data()),
+        list.records.size() * sizeof(LeakListBinaryRecord))) {
+        return false;
+    }
+    auto isValidIndex = [&list](uint32_t index) { return index < list.strings.size(); };
+    for (const LeakListBinaryRecord& record : list.records) {
+        if (!isValidIndex(record.nameIndex) || !isValidIndex(record.msgIndex)) {
+            return false;
+        }
+    }
+    return isValidIndex(header.snapshotHashIndex) &&
+        (header.versionIndex == LEAK_LIST_NO_STRING || isValidIndex(header.versionIndex));
+}
+
+bool ReadBinaryLeakList(const std::string& filePath, BinaryLeakList& list)
+{
+    int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    fdsan_exchange_owner_tag(fd, 0, LEAKLIST_FDTAG);
+    bool ret = ReadBinaryLeakListFromFd(fd, list);
+    fdsan_close_with_tag(fd, LEAKLIST_FDTAG);
+    return ret;
+}
+
+bool ExportLeakListJson(const BinaryLeakList& list, LeakListWriter& writer)
+{
+    const LeakListBinaryHeader& header = list.header;
+    std::string_view version = header.versionIndex == LEAK_LIST_NO_STRING ? "" : list.strings[header.versionIndex];
+    writer.Begin(version, list.strings[header.snapshotHashIndex]);
+    for (const LeakListBinaryRecord& record : list.records) {
+        writer.Add(record.hash, list.strings[record.nameIndex], list.strings[record.msgIndex]);
+    }
+    return writer.End();
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_LEAKLIST_H
+#define JS_LEAK_WATCHER_LEAKLIST_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "js_leak_watcher_registry.h"
+
+constexpr size_t LEAK_LIST_WRITE_BUFFER_SIZE = 64 * 1024;
+constexpr uint32_t LEAK_LIST_BINARY_MAGIC = 0x424C4C4A; // "JLLB"
+constexpr uint16_t LEAK_LIST_BINARY_VERSION = 1;
+constexpr uint32_t LEAK_LIST_NO_STRING = UINT32_MAX;
+
+/*
+ * Serializes a leak list as the same JSON text JSON.stringify produced for the .jsleaklist files, through
+ * a fixed buffer that is flushed to the fd whenever it fills, so no full copy of the document is built.
+ * Without an fd the text is appended to a string instead, for the short lists of a report.
+ */
+class LeakListWriter {
+public:
+    explicit LeakListWriter(int fd);
+    explicit LeakListWriter(std::string& out);
+    LeakListWriter(const LeakListWriter&) = delete;
+    LeakListWriter& operator = (const LeakListWriter&) = delete;
+
+    /* {"version":...,"snapshot_hash":...,"leakObjList":[ , version is left out when empty */
+    void Begin(std::string_view version, std::string_view snapshotHash);
+    void BeginArray();
+    void Add(uint32_t hash, std::string_view name, std::string_view msg);
+    /* {"name":...,"count":...} entry of a class summary */
+    void AddClassCount(std::string_view name, uint32_t count);
+    void EndArray();
+    /* closes what Begin opened and flushes, false when any write failed */
+    bool End();
+    bool Flush();
+    uint64_t GetWrittenSize() const;
+
+private:
+    void Append(std::string_view str);
+    void AppendString(std::string_view str);
+
+    int fd_ = -1;
+    std::string* out_ = nullptr;
+    std::vector<char> buffer_;
+    size_t used_ = 0;
+    uint64_t written_ = 0;
+    bool failed_ = false;
+    bool first_ = true;
+};
+
+/* the live entries of registry, or only those of hashes when it is not null, returns the number written */
+uint32_t WriteLeakObjects(LeakListWriter& writer, const LeakObjectRegistry& registry,
+    const std::vector<uint32_t>* hashes = nullptr);
+
+/*
+ * Binary .jsleaklist layout, little endian: the header, stringCount strings each stored as a uint32_t length
+ * followed by its bytes, then recordCount fixed size records whose name and message refer to the string
+ * table. Names and messages are written once however many objects share them. versionIndex is
+ * LEAK_LIST_NO_STRING for lists that had no version field in their JSON form.
+ */
+struct LeakListBinaryHeader {
+    uint32_t magic = LEAK_LIST_BINARY_MAGIC;
+    uint16_t version = LEAK_LIST_BINARY_VERSION;
+    uint16_t reserved = 0;
+    uint32_t stringCount = 0;
+    uint32_t recordCount = 0;
+    uint32_t versionIndex = LEAK_LIST_NO_STRING;
+    uint32_t snapshotHashIndex = LEAK_LIST_NO_STRING;
+};
+static_assert(sizeof(LeakListBinaryHeader) == 24, "binary leak list header is part of the file format");
+
+struct LeakListBinaryRecord {
+    uint64_t timestamp = 0;
+    uint32_t hash = 0;
+    uint32_t nameIndex = 0;
+    uint32_t msgIndex = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(LeakListBinaryRecord) == 24, "binary leak list record is part of the file format");
+
+struct BinaryLeakList {
+    LeakListBinaryHeader header;
+    std::vector<std::string> strings;
+    std::vector<LeakListBinaryRecord> records;
+};
+
+/* writes the live entries of registry to fd, size receives the bytes written */
+bool WriteBinaryLeakList(int fd, const LeakObjectRegistry& registry, std::string_view version,
+    std::string_view snapshotHash, uint64_t& size);
+bool ReadBinaryLeakList(const std::string& filePath, BinaryLeakList& list);
+/* the JSON document the same list would have been written as, records keep their order */
+bool ExportLeakListJson(const BinaryLeakList& list, LeakListWriter& writer);
+#endif // JS_LEAK_WATCHER_LEAKLIST_H
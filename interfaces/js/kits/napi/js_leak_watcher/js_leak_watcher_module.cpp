@@ -15,8 +15,10 @@
 
 #include "native_engine/native_engine.h"
 
+#ifdef JS_LEAK_WATCHER_EMBED_TS_SOURCE
 extern const char _binary_js_leak_watcher_ts_start[];
 extern const char _binary_js_leak_watcher_ts_end[];
+#endif
 extern const char _binary_js_leak_watcher_abc_start[];
 extern const char _binary_js_leak_watcher_abc_end[];
 
@@ -31,6 +33,8 @@ void NAPI_hiviewdfx_jsLeakWatcher_AutoRegister()
     napi_module_register(&_module);
 }
 
+#ifdef JS_LEAK_WATCHER_EMBED_TS_SOURCE
+// release builds load the module from the bytecode below only
 extern "C" __attribute__((visibility("default")))
 void NAPI_hiviewdfx_jsLeakWatcher_GetJSCode(const char **buf, int *bufLen)
 {
@@ -42,6 +46,7 @@ void NAPI_hiviewdfx_jsLeakWatcher_GetJSCode(const char **buf, int *bufLen)
         *bufLen = _binary_js_leak_watcher_ts_end - _binary_js_leak_watcher_ts_start;
     }
 }
+#endif
 
 // jsLeakWatcher js register
 extern "C" __attribute__((visibility("default")))
@@ -13,12 +13,28 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <mutex>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
+#include <vector>
+#include "hichecker_param_cache.h"
 #include "hilog/log.h"
+#include "js_leak_watcher_delta.h"
+#include "js_leak_watcher_dump_pool.h"
+#include "js_leak_watcher_filter.h"
+#include "js_leak_watcher_leaklist.h"
 #include "js_leak_watcher_napi.h"
+#include "js_leak_watcher_rawheap.h"
+#include "js_leak_watcher_registry.h"
+#include "js_leak_watcher_report.h"
+#include "js_leak_watcher_retention.h"
 #include "js_leak_watcher_ts.h"
-#include "sys_param.h"
 #include "hisysevent.h"
 #ifdef ENABLE_API_METRICS
 #include "histogram_plugin_macros.h"
@@ -29,21 +45,40 @@
 #undef LOG_TAG
 #define LOG_TAG "JSLEAK_WATCHER_C"
 
-#define JSLEAK_WATCHER_NAME_LEN 256
-
 using namespace OHOS::Ace;
 using namespace OHOS::AppExecFwk;
 using namespace OHOS::Rosen;
+using OHOS::HiviewDFX::HiCheckerParam;
+using OHOS::HiviewDFX::HiCheckerParamCache;
 using ArkUIRuntimeCallInfo = panda::JsiRuntimeCallInfo;
 
-struct TsfnContext {
-    napi_threadsafe_function tsfn;
-};
+static int WriteLeakEvent(const LeakReport& report);
 
 auto g_runner = EventRunner::Current();
 auto g_handler = std::make_shared<LeakWatcherEventHandler>(g_runner);
 auto g_listener = OHOS::sptr<WindowLifeCycleListener>::MakeSptr();
 napi_ref g_callbackRef = nullptr;
+bool g_lifecycleFlushPosted = false;
+std::vector<napi_ref> g_lifecycleBatch;
+LeakObjectRegistry g_leakRegistry;
+std::vector<uint32_t> g_gcLeakSnapshot;
+std::vector<uint32_t> g_reportedLeakHashes;
+LeakListDiff g_leakListDiff;
+LeakWatcherFilter g_leakFilter;
+DumpRetentionManager g_dumpRetention;
+DumpRequestPool g_dumpRequests;
+RawHeapDeltaEncoder g_deltaEncoder;
+LeakReportWorker g_reportWorker(WriteLeakEvent);
+struct DumpCompletionChannel {
+    napi_threadsafe_function tsfn = nullptr;
+    /* tells a channel apart from a later one created for an env at the same address */
+    uint64_t id = 0;
+    /* acquires held by dumps in flight, released on their behalf if the env is cleaned up first */
+    uint32_t inFlight = 0;
+};
+std::mutex g_dumpChannelLock;
+std::unordered_map<napi_env, DumpCompletionChannel> g_dumpChannels;
+uint64_t g_nextDumpChannelId = 1;
 
 static bool CreateFile(const std::string& filePath)
 {
@@ -85,47 +120,73 @@ static uint64_t GetFileSize(const std::string& filePath)
     return st.st_size;
 }
 
-static bool AppendMetaData(const std::string& filePath)
+static uint64_t GetDumpQuotaBytes()
+{
+    constexpr uint64_t bytesPerMb = 1024 * 1024;
+    return HiCheckerParamCache::GetUint64(HiCheckerParam::JSLEAK_DUMP_QUOTA) * bytesPerMb;
+}
+
+static bool AppendMetaData(const std::string& filePath, RawHeapDigest* digest = nullptr)
 {
 #ifdef __aarch64__
-    const char* metaDataPath = "/system/lib64/module/arkcompiler/metadata.json";
+    static RawHeapMetaData metaData("/system/lib64/module/arkcompiler/metadata.json");
 #else
-    const char* metaDataPath = "/system/lib/module/arkcompiler/metadata.json";
+    static RawHeapMetaData metaData("/system/lib/module/arkcompiler/metadata.json");
 #endif
-    auto rawHeapFileSize = static_cast<uint32_t>(GetFileSize(filePath));
-    auto metaDataFileSize = static_cast<uint32_t>(GetFileSize(metaDataPath));
-    FILE* targetFile = fopen(filePath.c_str(), "ab");
-    if (targetFile == nullptr) {
+    bool useSidecar = HiCheckerParamCache::GetBool(HiCheckerParam::RAWHEAP_SIDECAR);
+    return metaData.Append(filePath, useSidecar ? META_DATA_SIDECAR : META_DATA_INLINE, digest);
+}
+
+/* splits a rawheap path into its directory and the base name retention keys the dump by */
+static bool SplitRawHeapPath(const std::string& filePath, std::string& dir, std::string& baseName)
+{
+    constexpr const char* rawHeapSuffix = ".rawheap";
+    size_t pos = filePath.find_last_of('/');
+    if (pos == std::string::npos) {
         return false;
     }
-    FILE* metaDataFile = fopen(metaDataPath, "rb");
-    if (metaDataFile == nullptr) {
-        fclose(targetFile);
-        return false;
+    dir = filePath.substr(0, pos);
+    baseName = filePath.substr(pos + 1);
+    size_t suffixPos = baseName.rfind(rawHeapSuffix);
+    if (suffixPos != std::string::npos) {
+        baseName.resize(suffixPos);
     }
-    constexpr auto buffSize = 1024;
-    char buff[buffSize] = {0};
-    size_t readSize = 0;
-    while ((readSize = fread(buff, 1, buffSize, metaDataFile)) > 0) {
-        if (fwrite(buff, 1, readSize, targetFile) != readSize) {
-            fclose(targetFile);
-            fclose(metaDataFile);
-            return false;
-        }
+    return true;
+}
+
+/* a delta base has to outlive every delta written against it, not only until the next rebase */
+static void RetainDeltaBase(const std::string& filePath, bool isBase, const std::string& basePath)
+{
+    std::string dir;
+    std::string name;
+    std::string baseDir;
+    std::string baseName;
+    if (!SplitRawHeapPath(filePath, dir, name) || !SplitRawHeapPath(basePath, baseDir, baseName)) {
+        return;
     }
-    if (fwrite(&rawHeapFileSize, sizeof(rawHeapFileSize), 1, targetFile) != 1) {
-        fclose(targetFile);
-        fclose(metaDataFile);
-        return false;
+    if (isBase) {
+        g_dumpRetention.PinDump(dir, name);
+    } else {
+        g_dumpRetention.LinkDelta(dir, name, baseName);
     }
-    if (fwrite(&metaDataFileSize, sizeof(metaDataFileSize), 1, targetFile) != 1) {
-        fclose(targetFile);
-        fclose(metaDataFile);
-        return false;
+}
+
+/* writes the SHA-256 of the final rawheap to digest, false when it could not be finished */
+static bool FinishRawHeap(const std::string& filePath, char* digest, size_t digestSize)
+{
+    RawHeapDigest rawHeapDigest;
+    bool isBase = false;
+    std::string basePath;
+    if (HiCheckerParamCache::GetBool(HiCheckerParam::RAWHEAP_DELTA) &&
+        g_deltaEncoder.Encode(filePath, isBase, basePath)) {
+        RetainDeltaBase(filePath, isBase, basePath);
     }
-    fclose(targetFile);
-    fclose(metaDataFile);
-    return true;
+    if (HiCheckerParamCache::GetBool(HiCheckerParam::RAWHEAP_COMPRESS) &&
+        !CompressRawHeap(filePath, RAWHEAP_COMPRESS_BLOCK_SIZE, &rawHeapDigest)) {
+        HILOG_ERROR(LOG_CORE, "rawheap is kept uncompressed");
+    }
+    digest[0] = '\0';
+    return AppendMetaData(filePath, &rawHeapDigest) && rawHeapDigest.Final(digest, digestSize);
 }
 
 static napi_value CreateUndefined(napi_env env)
@@ -151,53 +212,273 @@ static bool GetCallbackRef(napi_env env, napi_callback_info info, napi_ref* ref)
     return true;
 }
 
+static void SettleDumpPromise(napi_env env, DumpRequestSlot* slot)
+{
+    auto deferred = static_cast<napi_deferred>(slot->deferred);
+    napi_value result = nullptr;
+    if (slot->retcode != 0 || slot->digest[0] == '\0') {
+        napi_create_uint32(env, slot->retcode, &result);
+        napi_reject_deferred(env, deferred, result);
+        return;
+    }
+    napi_value path = nullptr;
+    napi_value size = nullptr;
+    napi_value digest = nullptr;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, slot->filePath, NAPI_AUTO_LENGTH, &path);
+    napi_create_double(env, static_cast<double>(slot->fileSize), &size);
+    napi_create_string_utf8(env, slot->digest, NAPI_AUTO_LENGTH, &digest);
+    napi_set_named_property(env, result, "rawHeapPath", path);
+    napi_set_named_property(env, result, "fileSize", size);
+    napi_set_named_property(env, result, "sha256", digest);
+    napi_resolve_deferred(env, deferred, result);
+}
+
 static void MainThreadExec(napi_env env, napi_value jscb, void* context, void* data)
 {
     HILOG_INFO(LOG_CORE, "main thread callback starts");
-    uint8_t* pData = static_cast<uint8_t*>(data);
-    if (!pData) {
-        HILOG_ERROR(LOG_CORE, "MainThreadExec pData is nullptr!");
+    auto slot = static_cast<DumpRequestSlot*>(data);
+    if (slot == nullptr) {
+        HILOG_ERROR(LOG_CORE, "MainThreadExec slot is nullptr!");
         return;
     }
-    uint8_t value = *pData;
-
-    napi_value argv[1];
+    // env is null when the channel is torn down with the dump still queued
+    if (env == nullptr) {
+        g_dumpRequests.Release(slot);
+        return;
+    }
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(env, &scope);
+    if (slot->deferred != nullptr) {
+        SettleDumpPromise(env, slot);
+        g_dumpRequests.Release(slot);
+        napi_close_handle_scope(env, scope);
+        return;
+    }
+    auto callbackRef = static_cast<napi_ref>(slot->callback);
+    napi_value callback = nullptr;
     napi_value global = nullptr;
-    if (napi_get_global(env, &global) != napi_ok) {
-        HILOG_ERROR(LOG_CORE, "MainThreadExec napi_get_global failed");
-        delete pData;
+    napi_value argv[TWO_LIMIT];
+    if (napi_get_reference_value(env, callbackRef, &callback) != napi_ok || napi_get_global(env, &global) != napi_ok ||
+        napi_create_uint32(env, slot->retcode, &argv[0]) != napi_ok ||
+        napi_create_string_utf8(env, slot->digest, NAPI_AUTO_LENGTH, &argv[1]) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "MainThreadExec create callback args failed, request %{public}u", slot->requestId);
+    } else {
+        napi_call_function(env, global, callback, TWO_LIMIT, argv, nullptr);
+    }
+    napi_delete_reference(env, callbackRef);
+    g_dumpRequests.Release(slot);
+    napi_close_handle_scope(env, scope);
+}
+
+/*
+ * Drops the channel of an env that is going away. The acquires of the dumps still in flight are released
+ * here on their behalf, so the threadsafe function drains its queue and finalizes; those dumps find the
+ * channel gone and never touch it again.
+ */
+static void ReleaseDumpCompletionChannel(void* arg)
+{
+    std::lock_guard<std::mutex> lock(g_dumpChannelLock);
+    auto iter = g_dumpChannels.find(static_cast<napi_env>(arg));
+    if (iter == g_dumpChannels.end()) {
         return;
     }
-    if (napi_create_uint32(env, value, &argv[0]) != napi_ok) {
-        HILOG_ERROR(LOG_CORE, "MainThreadExec napi_create_uint32 failed");
-        delete pData;
+    for (uint32_t i = 0; i < iter->second.inFlight; i++) {
+        napi_release_threadsafe_function(iter->second.tsfn, napi_tsfn_release);
+    }
+    napi_release_threadsafe_function(iter->second.tsfn, napi_tsfn_release);
+    g_dumpChannels.erase(iter);
+}
+
+/*
+ * One threadsafe function per env delivers every rawheap completion; the callback to run travels in the
+ * request slot. It is unref'ed so it never keeps the loop alive, and released when the env is cleaned up.
+ * Every dump acquires it here and the slot remembers which channel it holds.
+ */
+static bool AcquireDumpCompletionChannel(napi_env env, DumpRequestSlot* slot)
+{
+    std::lock_guard<std::mutex> lock(g_dumpChannelLock);
+    auto iter = g_dumpChannels.find(env);
+    if (iter == g_dumpChannels.end()) {
+        napi_value name = nullptr;
+        napi_threadsafe_function tsfn = nullptr;
+        if (napi_create_string_utf8(env, "JsLeakWatcherDumpRawHeap", NAPI_AUTO_LENGTH, &name) != napi_ok ||
+            napi_create_threadsafe_function(env, nullptr, nullptr, name, 0, 1, nullptr, nullptr, nullptr,
+                                            MainThreadExec, &tsfn) != napi_ok) {
+            HILOG_ERROR(LOG_CORE, "DumpRawHeap create_threadsafe func failed");
+            return false;
+        }
+        napi_unref_threadsafe_function(env, tsfn);
+        napi_add_env_cleanup_hook(env, ReleaseDumpCompletionChannel, env);
+        DumpCompletionChannel channel;
+        channel.tsfn = tsfn;
+        channel.id = g_nextDumpChannelId++;
+        iter = g_dumpChannels.emplace(env, channel).first;
+    }
+    if (napi_acquire_threadsafe_function(iter->second.tsfn) != napi_ok) {
+        return false;
+    }
+    iter->second.inFlight++;
+    slot->env = env;
+    slot->channelId = iter->second.id;
+    return true;
+}
+
+/* queues the slot to the JS thread and gives back the acquire taken when the dump started */
+static void DeliverDumpCompletion(DumpRequestSlot* slot)
+{
+    std::lock_guard<std::mutex> lock(g_dumpChannelLock);
+    auto iter = g_dumpChannels.find(static_cast<napi_env>(slot->env));
+    if (iter == g_dumpChannels.end() || iter->second.id != slot->channelId) {
+        HILOG_ERROR(LOG_CORE, "DumpRawHeapImpl request %{public}u outlived its env", slot->requestId);
+        g_dumpRequests.Release(slot);
         return;
     }
-    napi_call_function(env, global, jscb, 1, argv, nullptr);
+    if (napi_call_threadsafe_function(iter->second.tsfn, slot, napi_tsfn_nonblocking) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "DumpRawHeapImpl request %{public}u not delivered", slot->requestId);
+        g_dumpRequests.Release(slot);
+    }
+    napi_release_threadsafe_function(iter->second.tsfn, napi_tsfn_release);
+    iter->second.inFlight--;
+}
 
-    if (context == nullptr) {
-        HILOG_ERROR(LOG_CORE, "MainThreadExec context is nullptr");
-    } else {
-        auto tsfnContext = static_cast<TsfnContext*>(context);
-        if (napi_release_threadsafe_function(tsfnContext->tsfn, napi_tsfn_release) != napi_status::napi_ok) {
-            HILOG_ERROR(LOG_CORE, "MainThreadExec release_threadsafe_function failed");
+static void ClearLifecycleBatch(napi_env env)
+{
+    for (napi_ref ref : g_lifecycleBatch) {
+        napi_delete_reference(env, ref);
+    }
+    g_lifecycleBatch.clear();
+}
+
+static void OnWatchedObjectFinalized(napi_env env, void* data, void* hint)
+{
+    g_leakRegistry.Remove(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(data)));
+}
+
+static bool GetConstructorName(napi_env env, napi_value object, std::string& name)
+{
+    napi_value constructor = nullptr;
+    napi_value value = nullptr;
+    return napi_get_named_property(env, object, "constructor", &constructor) == napi_ok &&
+        napi_get_named_property(env, constructor, "name", &value) == napi_ok &&
+        GetNapiStringValue(env, value, name);
+}
+
+/*
+ * Native counterpart of registerObject in js_leak_watcher.ts. The identity hash comes from the engine, like
+ * util.getHash, and a native finalizer, which holds the object weakly, drops the entry once it is collected.
+ */
+static uint64_t GetWatchTimestamp()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+static bool WatchObjectNative(napi_env env, napi_value object)
+{
+    napi_valuetype type = napi_undefined;
+    if (object == nullptr || napi_typeof(env, object, &type) != napi_ok || type != napi_object) {
+        return false;
+    }
+    std::string name;
+    if (!GetConstructorName(env, object, name)) {
+        return false;
+    }
+    uint32_t hash = static_cast<uint32_t>(reinterpret_cast<NativeEngine*>(env)->GetObjectHash(env, object));
+    if (!g_leakRegistry.Add(hash, name, "", GetWatchTimestamp())) {
+        return false;
+    }
+    void* data = reinterpret_cast<void*>(static_cast<uintptr_t>(hash));
+    if (napi_add_finalizer(env, object, data, OnWatchedObjectFinalized, nullptr, nullptr) != napi_ok) {
+        g_leakRegistry.Remove(hash);
+        return false;
+    }
+    return true;
+}
+
+/* the ArkUI lifecycle hook hands over a WeakRef, the component to watch is its target */
+static napi_value DerefLifecycleObject(napi_env env, napi_value weakRef)
+{
+    napi_valuetype type = napi_undefined;
+    if (weakRef == nullptr || napi_typeof(env, weakRef, &type) != napi_ok || type != napi_object) {
+        return nullptr;
+    }
+    napi_value deref = nullptr;
+    if (napi_get_named_property(env, weakRef, "deref", &deref) != napi_ok ||
+        napi_typeof(env, deref, &type) != napi_ok || type != napi_function) {
+        return nullptr;
+    }
+    napi_value object = nullptr;
+    if (napi_call_function(env, weakRef, deref, 0, nullptr, &object) != napi_ok) {
+        napi_value exception = nullptr;
+        napi_get_and_clear_last_exception(env, &exception);
+        return nullptr;
+    }
+    // undefined once the target was collected
+    if (object == nullptr || napi_typeof(env, object, &type) != napi_ok || type != napi_object) {
+        return nullptr;
+    }
+    return object;
+}
+
+/* registers every object buffered since the last flush, once the UI task that built them has finished */
+static void FlushLifecycleBatch(napi_env env)
+{
+    g_lifecycleFlushPosted = false;
+    if (g_lifecycleBatch.empty()) {
+        return;
+    }
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(env, &scope);
+    for (napi_ref ref : g_lifecycleBatch) {
+        napi_value object = nullptr;
+        if (napi_get_reference_value(env, ref, &object) == napi_ok) {
+            WatchObjectNative(env, object);
         }
     }
-    delete pData;
+    ClearLifecycleBatch(env);
+    napi_close_handle_scope(env, scope);
 }
 
-static napi_value RegisterArkUIObjectLifeCycleCallback(napi_env env, napi_callback_info info)
+/*
+ * Buffers the object until the current UI task, usually the frame that built it, has finished, so hashing,
+ * the registry insert and the finalizer stay out of the build; the flush task posted behind it registers
+ * the whole frame at once, and a full buffer is flushed right away.
+ */
+static bool WatchLifecycleObject(napi_env env, napi_value weakRef)
 {
-    napi_value ret;
-    if (!GetCallbackRef(env, info, &g_callbackRef)) {
-        napi_get_boolean(env, false, &ret);
-        return ret;
+    napi_value object = DerefLifecycleObject(env, weakRef);
+    napi_ref ref = nullptr;
+    if (object == nullptr || napi_create_reference(env, object, 1, &ref) != napi_ok) {
+        return false;
+    }
+    g_lifecycleBatch.push_back(ref);
+    if (g_lifecycleBatch.size() >= LIFECYCLE_BATCH_CAPACITY) {
+        FlushLifecycleBatch(env);
+        return true;
     }
+    if (!g_lifecycleFlushPosted) {
+        g_lifecycleFlushPosted = g_handler->PostTask([env]() { FlushLifecycleBatch(env); }, "JsLeakWatcherFlush");
+        if (!g_lifecycleFlushPosted) {
+            FlushLifecycleBatch(env);
+        }
+    }
+    return true;
+}
 
+static void WatchWindowNative(napi_env env, napi_value window, const OHOS::Rosen::WindowLifeCycleInfo& info)
+{
+    if (g_leakFilter.IsNameExcluded(info.windowName)) {
+        return;
+    }
+    WatchObjectNative(env, window);
+}
+
+static bool RegisterArkUIObjectLifecycle(napi_env env)
+{
     RefPtr<Kit::UIContext> uiContext = Kit::UIContext::Current();
     if (uiContext == nullptr) {
-        napi_get_boolean(env, false, &ret);
-        return ret;
+        return false;
     }
     uiContext->RegisterArkUIObjectLifecycleCallback([env](void* obj) {
         napi_handle_scope scope = nullptr;
@@ -205,6 +486,11 @@ static napi_value RegisterArkUIObjectLifeCycleCallback(napi_env env, napi_callba
         ArkUIRuntimeCallInfo* arkUIRuntimeCallInfo = reinterpret_cast<ArkUIRuntimeCallInfo*>(obj);
         panda::Local<panda::JSValueRef> firstArg = arkUIRuntimeCallInfo->GetCallArgRef(0);
         napi_value param = reinterpret_cast<napi_value>(*firstArg);
+        if (g_callbackRef == nullptr) {
+            WatchLifecycleObject(env, param);
+            napi_close_handle_scope(env, scope);
+            return;
+        }
         napi_value global = nullptr;
         napi_get_global(env, &global);
         napi_value callback = nullptr;
@@ -213,8 +499,29 @@ static napi_value RegisterArkUIObjectLifeCycleCallback(napi_env env, napi_callba
         napi_call_function(env, global, callback, 1, argv, nullptr);
         napi_close_handle_scope(env, scope);
     });
+    return true;
+}
 
-    napi_get_boolean(env, true, &ret);
+static napi_value RegisterArkUIObjectLifeCycleCallback(napi_env env, napi_callback_info info)
+{
+    napi_value ret;
+    if (!GetCallbackRef(env, info, &g_callbackRef)) {
+        napi_get_boolean(env, false, &ret);
+        return ret;
+    }
+    napi_get_boolean(env, RegisterArkUIObjectLifecycle(env), &ret);
+    return ret;
+}
+
+/* node containers and XComponents go from the UI callback to the leak registry, one frame per flush */
+static napi_value RegisterArkUIObjectLifeCycleNative(napi_env env, napi_callback_info info)
+{
+    napi_value ret;
+    if (g_callbackRef != nullptr) {
+        napi_delete_reference(env, g_callbackRef);
+        g_callbackRef = nullptr;
+    }
+    napi_get_boolean(env, RegisterArkUIObjectLifecycle(env), &ret);
     return ret;
 }
 
@@ -225,6 +532,9 @@ static napi_value UnregisterArkUIObjectLifeCycleCallback(napi_env env, napi_call
         return nullptr;
     }
     uiContext->UnregisterArkUIObjectLifecycleCallback();
+    if (env != nullptr) {
+        ClearLifecycleBatch(env);
+    }
     if (env != nullptr && g_callbackRef != nullptr) {
         napi_delete_reference(env, g_callbackRef);
         g_callbackRef = nullptr;
@@ -246,6 +556,15 @@ static napi_value RegisterWindowLifeCycleCallback(napi_env env, napi_callback_in
     return ret;
 }
 
+static napi_value RegisterWindowLifeCycleNative(napi_env env, napi_callback_info info)
+{
+    napi_value ret;
+    g_listener->SetEnvAndWatcher(env, WatchWindowNative);
+    WindowManager::GetInstance().RegisterWindowLifeCycleCallback(g_listener);
+    napi_get_boolean(env, true, &ret);
+    return ret;
+}
+
 static napi_value UnregisterWindowLifeCycleCallback(napi_env env, napi_callback_info info)
 {
     if (g_listener != nullptr) {
@@ -313,87 +632,421 @@ static napi_value SetGcDelay(napi_env env, napi_callback_info info)
 
 static napi_value GetDumpStatus(napi_env env, napi_callback_info info)
 {
-    napi_handle_scope scope = nullptr;
-    napi_open_handle_scope(env, &scope);
-
-    napi_value result;
-    char paraName[JSLEAK_WATCHER_NAME_LEN] = "hiviewdfx.hichecker.jsleakwatcher.dump";
-    CachedHandle appEnableHandle = CachedParameterCreate(paraName, "true");
-    if (appEnableHandle == nullptr) {
-        napi_get_boolean(env, true, &result);
-        napi_close_handle_scope(env, scope);
-        return result;
-    }
-    const char *paramValue = CachedParameterGet(appEnableHandle);
-    if (paramValue != nullptr && strlen(paramValue) != 0 && strcmp(paramValue, "false") == 0) {
-        CachedParameterDestroy(appEnableHandle);
-        napi_get_boolean(env, false, &result);
-        napi_close_handle_scope(env, scope);
-        return result;
-    }
-
-    CachedParameterDestroy(appEnableHandle);
-    napi_get_boolean(env, true, &result);
-    napi_close_handle_scope(env, scope);
+    napi_value result = nullptr;
+    napi_get_boolean(env, HiCheckerParamCache::GetBool(HiCheckerParam::JSLEAK_DUMP), &result);
     return result;
 }
 
+static int WriteLeakEvent(const LeakReport& report)
+{
+    return HiSysEventWrite(OHOS::HiviewDFX::HiSysEvent::Domain::RELIABILITY, "MEMORY_LEAK_JS_LEAK_WATCHER",
+        OHOS::HiviewDFX::HiSysEvent::EventType::FAULT,
+        "PID", report.pid, "HAPPEN_TIME", report.happenTime, "MODULE", report.module, "LEAK_LIST", report.leakList,
+        "DYNAMIC_RAWHEAP_PATH", report.leakListPath, "STATIC_RAWHEAP_PATH", report.leakListPath,
+        "LEAK_LIST_PATH", report.leakListPath, "LEAK_OBJECT_COUNT", report.leakObjectCount);
+}
+
+/*
+ * reportRawHeap(module, leakListPath) reports the persistent leaks of the last diff. Only the bundle name and
+ * the JSON array of dump files come from JS; the leak list is summarized to its top classes here and the
+ * event is written on the report worker.
+ */
 static napi_value ReportRawHeap(napi_env env, napi_callback_info info)
 {
-    HILOG_INFO(LOG_CORE, "hisysevent reportrawheap begin!");
     if (!GetjsLeakWatcherEnableStatus()) {
         return nullptr;
     }
-    napi_handle_scope scope = nullptr;
-    napi_open_handle_scope(env, &scope);
+    size_t argc = TWO_LIMIT;
+    napi_value argv[TWO_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    LeakReport report;
+    if (argc != TWO_LIMIT || !GetNapiStringValue(env, argv[0], report.module) ||
+        !GetNapiStringValue(env, argv[1], report.leakListPath)) {
+        HILOG_ERROR(LOG_CORE, "ReportRawHeap invalid params");
+        return nullptr;
+    }
+    report.pid = static_cast<int32_t>(getpid());
+    report.happenTime = std::to_string(GetWatchTimestamp());
+    report.leakObjectCount = static_cast<int32_t>(BuildLeakClassSummary(g_leakRegistry, g_leakListDiff.persistent,
+        LEAK_REPORT_TOP_CLASSES, report.leakList));
+    g_reportWorker.Submit(std::move(report));
+    return CreateUndefined(env);
+}
+
+static napi_value RegisterLeakObject(napi_env env, napi_callback_info info)
+{
+    napi_value ret = nullptr;
+    size_t argc = THREE_LIMIT;
+    napi_value argv[THREE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    int32_t hash = 0;
+    std::string name;
+    std::string msg;
+    if (argc != THREE_LIMIT || napi_get_value_int32(env, argv[0], &hash) != napi_ok ||
+        !GetNapiStringValue(env, argv[1], name) || !GetNapiStringValue(env, argv[TWO_LIMIT], msg)) {
+        HILOG_ERROR(LOG_CORE, "RegisterLeakObject invalid params");
+        napi_get_boolean(env, false, &ret);
+        return ret;
+    }
+    napi_get_boolean(env, g_leakRegistry.Add(static_cast<uint32_t>(hash), name, msg, GetWatchTimestamp()), &ret);
+    return ret;
+}
+
+static napi_value UnregisterLeakObject(napi_env env, napi_callback_info info)
+{
     size_t argc = ONE_VALUE_LIMIT;
     napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
     napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
-    if (argc != ONE_VALUE_LIMIT) {
-        napi_close_handle_scope(env, scope);
-        return nullptr;
+    int32_t hash = 0;
+    if (argc != ONE_VALUE_LIMIT || napi_get_value_int32(env, argv[0], &hash) != napi_ok) {
+        return CreateUndefined(env);
     }
+    g_leakRegistry.Remove(static_cast<uint32_t>(hash));
+    return CreateUndefined(env);
+}
 
-    napi_value value;
-    int32_t pid;
-    napi_get_named_property(env, argv[0], "pid", &value);
-    napi_get_value_int32(env, value, &pid);
+static napi_value GetLeakObjectCount(napi_env env, napi_callback_info info)
+{
+    napi_value result = nullptr;
+    napi_create_uint32(env, g_leakRegistry.Size(), &result);
+    return result;
+}
 
-    auto getStringProperty = [](napi_env env, napi_value obj, const char* propertyName) -> std::string {
-        napi_value propValue;
-        if (napi_get_named_property(env, obj, propertyName, &propValue) != napi_ok) {
-            return {};
-        }
+static napi_value ClearLeakObjects(napi_env env, napi_callback_info info)
+{
+    g_leakRegistry.Clear();
+    return CreateUndefined(env);
+}
 
-        size_t strLength = 0;
-        napi_get_value_string_utf8(env, propValue, nullptr, 0, &strLength);
+static napi_value OpenLeakListIterator(napi_env env, napi_callback_info info)
+{
+    g_leakRegistry.ResetCursor();
+    return CreateUndefined(env);
+}
 
+static napi_value CreateLeakObjectValue(napi_env env, const LeakObjectInfo& leakInfo)
+{
+    napi_value obj = nullptr;
+    napi_create_object(env, &obj);
+    napi_value value = nullptr;
+    napi_create_int32(env, static_cast<int32_t>(leakInfo.hash), &value);
+    napi_set_named_property(env, obj, "hash", value);
+    const std::string& name = g_leakRegistry.GetString(leakInfo.nameId);
+    napi_create_string_utf8(env, name.c_str(), name.size(), &value);
+    napi_set_named_property(env, obj, "name", value);
+    const std::string& msg = g_leakRegistry.GetString(leakInfo.msgId);
+    napi_create_string_utf8(env, msg.c_str(), msg.size(), &value);
+    napi_set_named_property(env, obj, "msg", value);
+    return obj;
+}
+
+static napi_value NextLeakListBatch(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t maxCount = LEAK_LIST_BATCH_SIZE;
+    if (argc == ONE_VALUE_LIMIT) {
+        napi_get_value_uint32(env, argv[0], &maxCount);
+    }
+    std::vector<LeakObjectInfo> batch;
+    batch.reserve(std::min(maxCount, g_leakRegistry.Size()));
+    g_leakRegistry.NextBatch(maxCount, batch);
+    napi_value result = nullptr;
+    napi_create_array_with_length(env, batch.size(), &result);
+    for (size_t i = 0; i < batch.size(); i++) {
+        napi_set_element(env, result, i, CreateLeakObjectValue(env, batch[i]));
+    }
+    return result;
+}
+
+static napi_value SnapshotLeakList(napi_env env, napi_callback_info info)
+{
+    g_leakRegistry.CollectHashes(g_gcLeakSnapshot);
+    napi_value result = nullptr;
+    napi_create_uint32(env, g_gcLeakSnapshot.size(), &result);
+    return result;
+}
+
+static void SetNamedUint32(napi_env env, napi_value obj, const char* name, uint32_t value)
+{
+    napi_value result = nullptr;
+    napi_create_uint32(env, value, &result);
+    napi_set_named_property(env, obj, name, result);
+}
+
+static napi_value DiffLeakList(napi_env env, napi_callback_info info)
+{
+    bool unchanged = IsSameLeakHashSet(g_gcLeakSnapshot, g_reportedLeakHashes);
+    if (!unchanged) {
+        std::vector<uint32_t> liveHashes;
+        g_leakRegistry.CollectHashes(liveHashes);
+        DiffLeakHashes(g_gcLeakSnapshot, liveHashes, g_leakListDiff);
+        g_reportedLeakHashes = g_leakListDiff.persistent;
+    }
+    napi_value result = nullptr;
+    napi_create_object(env, &result);
+    napi_value value = nullptr;
+    napi_get_boolean(env, unchanged, &value);
+    napi_set_named_property(env, result, "unchanged", value);
+    SetNamedUint32(env, result, "added", g_leakListDiff.added.size());
+    SetNamedUint32(env, result, "removed", g_leakListDiff.removed.size());
+    SetNamedUint32(env, result, "persistent", g_leakListDiff.persistent.size());
+    return result;
+}
+
+static napi_value GetPersistentLeakList(napi_env env, napi_callback_info info)
+{
+    napi_value result = nullptr;
+    napi_create_array_with_length(env, g_leakListDiff.persistent.size(), &result);
+    uint32_t index = 0;
+    LeakObjectInfo leakInfo;
+    for (uint32_t hash : g_leakListDiff.persistent) {
+        if (g_leakRegistry.Find(hash, leakInfo)) {
+            napi_set_element(env, result, index++, CreateLeakObjectValue(env, leakInfo));
+        }
+    }
+    return result;
+}
+
+static bool GetNapiStringArray(napi_env env, napi_value value, std::vector<std::string>& strs)
+{
+    bool isArray = false;
+    uint32_t length = 0;
+    if (napi_is_array(env, value, &isArray) != napi_ok || !isArray ||
+        napi_get_array_length(env, value, &length) != napi_ok) {
+        return false;
+    }
+    strs.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
         std::string str;
-        str.resize(strLength);
-        napi_get_value_string_utf8(env, propValue, str.data(), strLength + 1, nullptr);
-        return str;
-    };
-    std::string happenTime = getStringProperty(env, argv[0], "happenTime");
-    std::string module = getStringProperty(env, argv[0], "module");
-    std::string leakList = getStringProperty(env, argv[0], "leakList");
-    std::string dynamicRawHeapPath = getStringProperty(env, argv[0], "dynamicRawheapPath");
-    std::string staticRawHeapPath = getStringProperty(env, argv[0], "staticRawheapPath");
-    std::string leakListPath = getStringProperty(env, argv[0], "leakListPath");
-    int32_t leakObjectCount = 0;
-    napi_get_named_property(env, argv[0], "leakObjectCount", &value);
-    napi_get_value_int32(env, value, &leakObjectCount);
-
-    int ret = HiSysEventWrite(OHOS::HiviewDFX::HiSysEvent::Domain::RELIABILITY, "MEMORY_LEAK_JS_LEAK_WATCHER",
-        OHOS::HiviewDFX::HiSysEvent::EventType::FAULT,
-        "PID", pid, "HAPPEN_TIME", happenTime, "MODULE", module, "LEAK_LIST", leakList,
-        "DYNAMIC_RAWHEAP_PATH", dynamicRawHeapPath, "STATIC_RAWHEAP_PATH", staticRawHeapPath,
-        "LEAK_LIST_PATH", leakListPath, "LEAK_OBJECT_COUNT", leakObjectCount);
-    if (ret != 0) {
-        HILOG_ERROR(LOG_CORE, "hisysevent report failed! ret %{public}d.", ret);
+        if (napi_get_element(env, value, i, &element) == napi_ok && GetNapiStringValue(env, element, str)) {
+            strs.emplace_back(std::move(str));
+        }
     }
+    return true;
+}
 
-    HILOG_INFO(LOG_CORE, "hisysevent reportrawheap end!");
-    napi_close_handle_scope(env, scope);
+static bool GetNapiInt64Array(napi_env env, napi_value value, std::vector<int64_t>& nums)
+{
+    bool isArray = false;
+    uint32_t length = 0;
+    if (napi_is_array(env, value, &isArray) != napi_ok || !isArray ||
+        napi_get_array_length(env, value, &length) != napi_ok) {
+        return false;
+    }
+    nums.reserve(length);
+    for (uint32_t i = 0; i < length; i++) {
+        napi_value element = nullptr;
+        int64_t num = 0;
+        if (napi_get_element(env, value, i, &element) == napi_ok &&
+            napi_get_value_int64(env, element, &num) == napi_ok) {
+            nums.push_back(num);
+        }
+    }
+    return true;
+}
+
+static napi_value SetLeakWatcherFilter(napi_env env, napi_callback_info info)
+{
+    size_t argc = TWO_LIMIT;
+    napi_value argv[TWO_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::vector<std::string> exclusionList;
+    std::vector<int64_t> objectIds;
+    if (argc != TWO_LIMIT || !GetNapiStringArray(env, argv[0], exclusionList) ||
+        !GetNapiInt64Array(env, argv[1], objectIds)) {
+        HILOG_ERROR(LOG_CORE, "SetLeakWatcherFilter invalid params");
+        g_leakFilter.Clear();
+        return CreateUndefined(env);
+    }
+    g_leakFilter.SetExclusionList(exclusionList);
+    g_leakFilter.SetObjectIds(objectIds);
+    return CreateUndefined(env);
+}
+
+static bool IsNapiNameExcluded(napi_env env, napi_value value)
+{
+    char name[MAX_OBJECT_NAME_LENGTH] = {0};
+    size_t length = 0;
+    if (napi_get_value_string_utf8(env, value, name, sizeof(name), &length) != napi_ok) {
+        return false;
+    }
+    if (length + 1 < sizeof(name)) {
+        return g_leakFilter.IsNameExcluded(std::string_view(name, length));
+    }
+    std::string longName;
+    return GetNapiStringValue(env, value, longName) && g_leakFilter.IsNameExcluded(longName);
+}
+
+static napi_value IsLeakNameExcluded(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    napi_value ret = nullptr;
+    napi_get_boolean(env, argc == ONE_VALUE_LIMIT && IsNapiNameExcluded(env, argv[0]), &ret);
+    return ret;
+}
+
+static napi_value IsLeakObjectFiltered(napi_env env, napi_callback_info info)
+{
+    size_t argc = TWO_LIMIT;
+    napi_value argv[TWO_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    napi_value ret = nullptr;
+    if (argc != TWO_LIMIT) {
+        napi_get_boolean(env, false, &ret);
+        return ret;
+    }
+    int64_t id = 0;
+    bool hasId = napi_get_value_int64(env, argv[1], &id) == napi_ok;
+    bool idMonitored = g_leakFilter.IsIdMonitored(hasId, id);
+    bool filtered = !idMonitored && (g_leakFilter.HasObjectIds() || IsNapiNameExcluded(env, argv[0]));
+    napi_get_boolean(env, filtered, &ret);
+    return ret;
+}
+
+static napi_value SetDumpRetention(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t maxDumps = 0;
+    if (argc != ONE_VALUE_LIMIT || napi_get_value_uint32(env, argv[0], &maxDumps) != napi_ok || maxDumps == 0) {
+        HILOG_ERROR(LOG_CORE, "SetDumpRetention invalid params");
+        return CreateUndefined(env);
+    }
+    g_dumpRetention.SetLimits(maxDumps, GetDumpQuotaBytes());
+    return CreateUndefined(env);
+}
+
+static napi_value PrepareDumpDir(napi_env env, napi_callback_info info)
+{
+    size_t argc = THREE_LIMIT;
+    napi_value argv[THREE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::string dir;
+    std::string prefix;
+    bool firstDump = false;
+    if (argc != THREE_LIMIT || !GetNapiStringValue(env, argv[0], dir) || !GetNapiStringValue(env, argv[1], prefix) ||
+        napi_get_value_bool(env, argv[TWO_LIMIT], &firstDump) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "PrepareDumpDir invalid params");
+        return CreateUndefined(env);
+    }
+    g_dumpRetention.PrepareDump(dir, prefix, firstDump);
+    return CreateUndefined(env);
+}
+
+/*
+ * writeLeakList(filePath, snapshotHash, version) streams every watched object to filePath in the .jsleaklist
+ * JSON layout, or in the binary layout when leaklist.binary is set, and returns { path, size }, or undefined
+ * when the file could not be written.
+ */
+static napi_value WriteLeakList(napi_env env, napi_callback_info info)
+{
+    size_t argc = THREE_LIMIT;
+    napi_value argv[THREE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::string filePath;
+    std::string snapshotHash;
+    std::string version;
+    if (argc != THREE_LIMIT || !GetNapiStringValue(env, argv[0], filePath) ||
+        !GetNapiStringValue(env, argv[1], snapshotHash) || !GetNapiStringValue(env, argv[TWO_LIMIT], version)) {
+        HILOG_ERROR(LOG_CORE, "WriteLeakList invalid params");
+        return CreateUndefined(env);
+    }
+    const mode_t defaultMode = S_IRUSR | S_IWUSR | S_IRGRP; // -rw-r-----
+    int fd = open(filePath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, defaultMode);
+    if (fd < 0) {
+        HILOG_ERROR(LOG_CORE, "open leak list file failed, errno: %{public}d", errno);
+        return CreateUndefined(env);
+    }
+    fdsan_exchange_owner_tag(fd, 0, FDTAG);
+    uint64_t fileSize = 0;
+    bool ret = false;
+    if (HiCheckerParamCache::GetBool(HiCheckerParam::LEAKLIST_BINARY)) {
+        ret = WriteBinaryLeakList(fd, g_leakRegistry, version, snapshotHash, fileSize);
+    } else {
+        LeakListWriter writer(fd);
+        writer.Begin(version, snapshotHash);
+        WriteLeakObjects(writer, g_leakRegistry);
+        ret = writer.End();
+        fileSize = writer.GetWrittenSize();
+    }
+    fdsan_close_with_tag(fd, FDTAG);
+    if (!ret) {
+        HILOG_ERROR(LOG_CORE, "write leak list file failed, errno: %{public}d", errno);
+        return CreateUndefined(env);
+    }
+    napi_value result = nullptr;
+    napi_value path = nullptr;
+    napi_value size = nullptr;
+    napi_create_object(env, &result);
+    napi_create_string_utf8(env, filePath.c_str(), filePath.size(), &path);
+    napi_create_double(env, static_cast<double>(fileSize), &size);
+    napi_set_named_property(env, result, "path", path);
+    napi_set_named_property(env, result, "size", size);
+    return result;
+}
+
+static napi_value CommitDump(napi_env env, napi_callback_info info)
+{
+    size_t argc = TWO_LIMIT;
+    napi_value argv[TWO_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::string dir;
+    std::string baseName;
+    if (argc != TWO_LIMIT || !GetNapiStringValue(env, argv[0], dir) || !GetNapiStringValue(env, argv[1], baseName)) {
+        HILOG_ERROR(LOG_CORE, "CommitDump invalid params");
+        return CreateUndefined(env);
+    }
+    g_dumpRetention.CommitDump(dir, baseName);
+    return CreateUndefined(env);
+}
+
+static napi_value SetLeakCountThreshold(napi_env env, napi_callback_info info)
+{
+    size_t argc = TWO_LIMIT;
+    napi_value argv[TWO_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    uint32_t fgThreshold = 0;
+    uint32_t bgThreshold = 0;
+    if (argc != TWO_LIMIT || napi_get_value_uint32(env, argv[0], &fgThreshold) != napi_ok ||
+        napi_get_value_uint32(env, argv[1], &bgThreshold) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "SetLeakCountThreshold invalid params");
+        return CreateUndefined(env);
+    }
+    g_handler->GetThresholdGate().SetThresholds(fgThreshold, bgThreshold);
+    return CreateUndefined(env);
+}
+
+static napi_value SetAppState(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    int32_t state = APP_STATE_UNKNOWN;
+    if (argc != ONE_VALUE_LIMIT || napi_get_value_int32(env, argv[0], &state) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "SetAppState invalid params");
+        return CreateUndefined(env);
+    }
+    g_handler->GetThresholdGate().SetAppState(state);
+    return CreateUndefined(env);
+}
+
+static napi_value SetGcRetryPending(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    bool pending = false;
+    if (argc != ONE_VALUE_LIMIT || napi_get_value_bool(env, argv[0], &pending) != napi_ok) {
+        HILOG_ERROR(LOG_CORE, "SetGcRetryPending invalid params");
+        return CreateUndefined(env);
+    }
+    g_handler->GetThresholdGate().SetRetryPending(pending);
     return CreateUndefined(env);
 }
 
@@ -405,6 +1058,7 @@ static napi_value HandleGCTask(napi_env env, napi_callback_info info)
     }
     g_handler->SetEnv(env);
     g_handler->SetGcFuncRef(ref);
+    g_handler->SetLeakRegistry(&g_leakRegistry);
     g_handler->SendEvent(GC_EVENT_ID, g_handler->GetGcDelayTime(), LeakWatcherEventHandler::Priority::IDLE);
     return CreateUndefined(env);
 }
@@ -426,8 +1080,26 @@ static napi_value RemoveTask(napi_env env, napi_callback_info info)
     return CreateUndefined(env);
 }
 
-static void DumpRawHeapImpl(TsfnContext* tsfnContext, napi_callback_info info, std::string& filePath)
+static void CompleteDumpRequest(DumpRequestSlot* slot, uint8_t retcode)
 {
+    HILOG_INFO(LOG_CORE, "DumpRawHeapImpl request %{public}u get retcode: %{public}d", slot->requestId, retcode);
+    // JS is notified only once the file is final, so the digest matches what it reads afterwards
+    slot->retcode = retcode;
+    slot->digest[0] = '\0';
+    slot->fileSize = 0;
+    if (retcode != 0) {
+        // a failed snapshot may be truncated, it never becomes a delta base and gets no digest
+        AppendMetaData(slot->filePath);
+    } else if (FinishRawHeap(slot->filePath, slot->digest, sizeof(slot->digest))) {
+        slot->fileSize = GetFileSize(slot->filePath);
+    }
+    DeliverDumpCompletion(slot);
+}
+
+static void DumpRawHeapImpl(DumpRequestSlot* slot, napi_callback_info info)
+{
+    auto cbinfo = reinterpret_cast<panda::JsiRuntimeCallInfo*>(info);
+    auto vm = cbinfo->GetVM();
     panda::ecmascript::DumpSnapShotOption dumpOption;
     dumpOption.isVmMode = true;
     dumpOption.isJSLeakWatcher = true;
@@ -435,19 +1107,8 @@ static void DumpRawHeapImpl(TsfnContext* tsfnContext, napi_callback_info info, s
     dumpOption.isBeforeFill = false;
     dumpOption.isSync = false;
     dumpOption.dumpFormat = panda::ecmascript::DumpFormat::BINARY;
-    auto cbinfo = reinterpret_cast<panda::JsiRuntimeCallInfo*>(info);
-    auto vm = cbinfo->GetVM();
-    panda::DFXJSNApi::DumpHeapSnapshot(vm, filePath, dumpOption,
-                                       [tsfnContext, filePath](uint8_t retcode) {
-        HILOG_INFO(LOG_CORE, "DumpRawHeapImpl callback get retcode: %{public}d", retcode);
-        uint8_t* pData = new uint8_t(retcode);
-        if (tsfnContext == nullptr || tsfnContext->tsfn == nullptr) {
-            HILOG_INFO(LOG_CORE, "DumpRawHeapImpl callback tsfnContext invalid!");
-            delete pData;
-        } else {
-            napi_call_threadsafe_function(tsfnContext->tsfn, pData, napi_tsfn_nonblocking);
-        }
-        AppendMetaData(filePath);
+    panda::DFXJSNApi::DumpHeapSnapshot(vm, slot->filePath, dumpOption, [slot](uint8_t retcode) {
+        CompleteDumpRequest(slot, retcode);
     });
     panda::DFXJSNApi::DestroyHeapProfiler(vm);
 }
@@ -473,22 +1134,71 @@ static napi_value DumpRawHeap(napi_env env, napi_callback_info info)
     }
     if (!CreateFile(filePath)) {
         napi_close_handle_scope(env, scope);
-        return nullptr;
+        return CreateUndefined(env);
     }
-    TsfnContext* tsfnContext = new TsfnContext();
-    if (napi_create_threadsafe_function(env, argv[1], nullptr, CreateUndefined(env), 0, 1, tsfnContext,
-                                        [](napi_env, void* finalizeData, void* context) {
-                                            delete static_cast<TsfnContext*>(finalizeData);
-                                        }, tsfnContext, MainThreadExec, &tsfnContext->tsfn)
-        != napi_status::napi_ok) {
-            HILOG_ERROR(LOG_CORE, "DumpRawHeap create_threadsafe func failed");
-            delete tsfnContext;
-            napi_close_handle_scope(env, scope);
-            return CreateUndefined(env);
+    napi_ref callbackRef = nullptr;
+    if (napi_create_reference(env, argv[1], 1, &callbackRef) != napi_ok) {
+        napi_close_handle_scope(env, scope);
+        return CreateUndefined(env);
+    }
+    DumpRequestSlot* slot = g_dumpRequests.Acquire(callbackRef);
+    if (slot == nullptr || !slot->SetFilePath(filePath) || !AcquireDumpCompletionChannel(env, slot)) {
+        HILOG_ERROR(LOG_CORE, "DumpRawHeap start dump failed, pending: %{public}u", g_dumpRequests.GetPendingCount());
+        g_dumpRequests.Release(slot);
+        // the caller still gets its one callback, with the code of a dump that never started
+        napi_value global = nullptr;
+        napi_value cbArgv[TWO_LIMIT] = {nullptr};
+        napi_get_global(env, &global);
+        napi_create_uint32(env, RAWHEAP_DUMP_START_FAILED, &cbArgv[0]);
+        napi_create_string_utf8(env, "", 0, &cbArgv[1]);
+        napi_call_function(env, global, argv[1], TWO_LIMIT, cbArgv, nullptr);
+        napi_delete_reference(env, callbackRef);
+        napi_close_handle_scope(env, scope);
+        return CreateUndefined(env);
     }
-    DumpRawHeapImpl(tsfnContext, info, filePath);
+    uint32_t requestId = slot->requestId;
+    DumpRawHeapImpl(slot, info);
     napi_close_handle_scope(env, scope);
-    return CreateUndefined(env);
+    napi_value result = nullptr;
+    napi_create_uint32(env, requestId, &result);
+    return result;
+}
+
+/*
+ * Promise variant of DumpRawHeapSync: the snapshot is taken by the engine dump thread, which also finishes
+ * the footer and metadata, and the promise settles through the dump completion channel. It resolves with
+ * { rawHeapPath, fileSize, sha256 } and rejects with the engine return code.
+ */
+static napi_value DumpRawHeapAsync(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::string filePath;
+    if (argc != ONE_VALUE_LIMIT || !GetNapiStringValue(env, argv[0], filePath)) {
+        HILOG_ERROR(LOG_CORE, "DumpRawHeapAsync invalid params");
+        return CreateUndefined(env);
+    }
+    napi_deferred deferred = nullptr;
+    napi_value promise = nullptr;
+    if (napi_create_promise(env, &deferred, &promise) != napi_ok) {
+        return CreateUndefined(env);
+    }
+    DumpRequestSlot* slot = nullptr;
+    if (CreateFile(filePath)) {
+        slot = g_dumpRequests.Acquire(nullptr);
+    }
+    if (slot == nullptr || !slot->SetFilePath(filePath) || !AcquireDumpCompletionChannel(env, slot)) {
+        HILOG_ERROR(LOG_CORE, "DumpRawHeapAsync start dump failed");
+        g_dumpRequests.Release(slot);
+        napi_value error = nullptr;
+        napi_create_uint32(env, RAWHEAP_DUMP_START_FAILED, &error);
+        napi_reject_deferred(env, deferred, error);
+        return promise;
+    }
+    slot->deferred = deferred;
+    DumpRawHeapImpl(slot, info);
+    return promise;
 }
 
 static napi_value DumpRawHeapSync(napi_env env, napi_callback_info info)
@@ -513,9 +1223,27 @@ static napi_value DumpRawHeapSync(napi_env env, napi_callback_info info)
     }
     NativeEngine *engine = reinterpret_cast<NativeEngine*>(env);
     engine->DumpHeapSnapshot(filePath, true, DumpFormat::BINARY, false, true, true);
-    AppendMetaData(filePath);
+    char digest[DUMP_DIGEST_BUFFER_SIZE] = {0};
+    FinishRawHeap(filePath, digest, sizeof(digest));
     napi_close_handle_scope(env, scope);
-    return CreateUndefined(env);
+    napi_value result = nullptr;
+    napi_create_string_utf8(env, digest, NAPI_AUTO_LENGTH, &result);
+    return result;
+}
+
+static napi_value GetHeapDumpSHA256(napi_env env, napi_callback_info info)
+{
+    size_t argc = ONE_VALUE_LIMIT;
+    napi_value argv[ONE_VALUE_LIMIT] = {nullptr};
+    napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+    std::string filePath;
+    if (argc != ONE_VALUE_LIMIT || !GetNapiStringValue(env, argv[0], filePath)) {
+        return CreateUndefined(env);
+    }
+    std::string digest = GetFileSHA256(filePath);
+    napi_value result = nullptr;
+    napi_create_string_utf8(env, digest.c_str(), digest.size(), &result);
+    return result;
 }
 
 static napi_value ApiRecord(napi_env env, napi_callback_info info)
@@ -552,7 +1280,9 @@ napi_value DeclareJsLeakWatcherInterface(napi_env env, napi_value exports)
     napi_property_descriptor desc[] = {
         DECLARE_NAPI_FUNCTION("registerArkUIObjectLifeCycleCallback", RegisterArkUIObjectLifeCycleCallback),
         DECLARE_NAPI_FUNCTION("unregisterArkUIObjectLifeCycleCallback", UnregisterArkUIObjectLifeCycleCallback),
+        DECLARE_NAPI_FUNCTION("registerArkUIObjectLifeCycleNative", RegisterArkUIObjectLifeCycleNative),
         DECLARE_NAPI_FUNCTION("registerWindowLifeCycleCallback", RegisterWindowLifeCycleCallback),
+        DECLARE_NAPI_FUNCTION("registerWindowLifeCycleNative", RegisterWindowLifeCycleNative),
         DECLARE_NAPI_FUNCTION("unregisterWindowLifeCycleCallback", UnregisterWindowLifeCycleCallback),
         DECLARE_NAPI_FUNCTION("removeTask", RemoveTask),
         DECLARE_NAPI_FUNCTION("handleDumpTask", HandleDumpTask),
@@ -560,11 +1290,32 @@ napi_value DeclareJsLeakWatcherInterface(napi_env env, napi_value exports)
         DECLARE_NAPI_FUNCTION("handleShutdownTask", HandleShutdownTask),
         DECLARE_NAPI_FUNCTION("dumpRawHeap", DumpRawHeap),
         DECLARE_NAPI_FUNCTION("dumpRawHeapSync", DumpRawHeapSync),
+        DECLARE_NAPI_FUNCTION("dumpRawHeapAsync", DumpRawHeapAsync),
+        DECLARE_NAPI_FUNCTION("getHeapDumpSHA256", GetHeapDumpSHA256),
         DECLARE_NAPI_FUNCTION("setGcDelay", SetGcDelay),
         DECLARE_NAPI_FUNCTION("setDumpDelay", SetDumpDelay),
         DECLARE_NAPI_FUNCTION("getDumpStatus", GetDumpStatus),
         DECLARE_NAPI_FUNCTION("reportRawHeap", ReportRawHeap),
         DECLARE_NAPI_FUNCTION("apiRecord", ApiRecord),
+        DECLARE_NAPI_FUNCTION("registerLeakObject", RegisterLeakObject),
+        DECLARE_NAPI_FUNCTION("unregisterLeakObject", UnregisterLeakObject),
+        DECLARE_NAPI_FUNCTION("getLeakObjectCount", GetLeakObjectCount),
+        DECLARE_NAPI_FUNCTION("clearLeakObjects", ClearLeakObjects),
+        DECLARE_NAPI_FUNCTION("openLeakListIterator", OpenLeakListIterator),
+        DECLARE_NAPI_FUNCTION("nextLeakListBatch", NextLeakListBatch),
+        DECLARE_NAPI_FUNCTION("snapshotLeakList", SnapshotLeakList),
+        DECLARE_NAPI_FUNCTION("diffLeakList", DiffLeakList),
+        DECLARE_NAPI_FUNCTION("getPersistentLeakList", GetPersistentLeakList),
+        DECLARE_NAPI_FUNCTION("writeLeakList", WriteLeakList),
+        DECLARE_NAPI_FUNCTION("setLeakWatcherFilter", SetLeakWatcherFilter),
+        DECLARE_NAPI_FUNCTION("isLeakNameExcluded", IsLeakNameExcluded),
+        DECLARE_NAPI_FUNCTION("isLeakObjectFiltered", IsLeakObjectFiltered),
+        DECLARE_NAPI_FUNCTION("setDumpRetention", SetDumpRetention),
+        DECLARE_NAPI_FUNCTION("prepareDumpDir", PrepareDumpDir),
+        DECLARE_NAPI_FUNCTION("commitDump", CommitDump),
+        DECLARE_NAPI_FUNCTION("setLeakCountThreshold", SetLeakCountThreshold),
+        DECLARE_NAPI_FUNCTION("setAppState", SetAppState),
+        DECLARE_NAPI_FUNCTION("setGcRetryPending", SetGcRetryPending),
     };
     NAPI_CALL(env, napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc));
     return exports;
@@ -601,3 +1352,18 @@ bool TestAppendMetaData(const std::string& filePath)
 {
     return AppendMetaData(filePath);
 }
+
+bool TestWatchLifecycleObject(napi_env env, napi_value weakRef)
+{
+    return WatchLifecycleObject(env, weakRef);
+}
+
+void TestFlushLifecycleBatch(napi_env env)
+{
+    FlushLifecycleBatch(env);
+}
+
+LeakObjectRegistry& GetTestLeakRegistry()
+{
+    return g_leakRegistry;
+}
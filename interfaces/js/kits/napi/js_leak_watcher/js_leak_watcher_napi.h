@@ -21,6 +21,8 @@
 #include "ui/view/ui_context.h"
 #include "window_manager.h"
 #include "ecmascript/napi/include/dfx_jsnapi.h"
+#include "js_leak_watcher_registry.h"
+#include "js_leak_watcher_scheduler.h"
 #include <string>
 #include <cstdint>
 #include <memory>
@@ -29,6 +31,11 @@ constexpr uint32_t DUMP_EVENT_ID = 0;
 constexpr uint32_t GC_EVENT_ID = 1;
 constexpr uint32_t ONE_VALUE_LIMIT = 1;
 constexpr uint32_t TWO_LIMIT = 2;
+constexpr uint32_t THREE_LIMIT = 3;
+constexpr uint32_t LEAK_LIST_BATCH_SIZE = 512;
+constexpr size_t MAX_OBJECT_NAME_LENGTH = 256;
+constexpr size_t LIFECYCLE_BATCH_CAPACITY = 256;
+constexpr uint32_t RAWHEAP_DUMP_START_FAILED = 0xFF;
 
 class LeakWatcherEventHandler : public OHOS::AppExecFwk::EventHandler {
 public:
@@ -44,9 +51,15 @@ public:
         if (eventId == DUMP_EVENT_ID) {
             ExecuteJsFunc(dumpFuncRef_);
         } else if (eventId == GC_EVENT_ID) {
-            ExecuteJsFunc(gcFuncRef_);
-            SendEvent(GC_EVENT_ID, gcDelayTime_, Priority::IDLE);
-            SendEvent(DUMP_EVENT_ID, dumpDelayTime_, Priority::IDLE);
+            bool runGc = registry_ == nullptr || (!gate_.IsBelowThreshold(registry_->Size()) &&
+                scheduler_.OnTick(registry_->GetBirthCount(), registry_->GetDeathCount(), registry_->Size()));
+            if (runGc) {
+                ExecuteJsFunc(gcFuncRef_);
+            }
+            SendEvent(GC_EVENT_ID, scheduler_.GetInterval(), Priority::IDLE);
+            if (runGc) {
+                SendEvent(DUMP_EVENT_ID, dumpDelayTime_, Priority::IDLE);
+            }
         }
     }
     
@@ -57,11 +70,19 @@ public:
 
     void SetGcDelayTime(uint32_t delay)
     {
-        gcDelayTime_ = delay;
+        scheduler_.SetMaxInterval(delay);
     }
     uint32_t GetGcDelayTime() const
     {
-        return gcDelayTime_;
+        return scheduler_.GetMaxInterval();
+    }
+    void SetLeakRegistry(const LeakObjectRegistry* registry)
+    {
+        registry_ = registry;
+    }
+    LeakThresholdGate& GetThresholdGate()
+    {
+        return gate_;
     }
     uint32_t GetDumpDelayTime() const
     {
@@ -110,6 +131,8 @@ private:
     }
     void Reset()
     {
+        scheduler_.Reset();
+        gate_.Reset();
         if (env_ != nullptr && dumpFuncRef_ != nullptr) {
             napi_delete_reference(env_, dumpFuncRef_);
             dumpFuncRef_ = nullptr;
@@ -129,15 +152,24 @@ private:
     napi_ref shutdownFuncRef_ = nullptr;
     bool isRunning_ = false;
     uint32_t dumpDelayTime_ = 3000; // 3s
-    uint32_t gcDelayTime_ = 90000; // 90s
+    LeakWatcherScheduler scheduler_;
+    LeakThresholdGate gate_;
+    const LeakObjectRegistry* registry_ = nullptr;
 };
 
+using NativeWindowWatcher = void (*)(napi_env env, napi_value window, const OHOS::Rosen::WindowLifeCycleInfo& info);
+
 class WindowLifeCycleListener : public OHOS::Rosen::IWindowLifeCycleListener {
 public:
     void OnWindowDestroyed(const OHOS::Rosen::WindowLifeCycleInfo& info, void* jsWindowNapiValue) override
     {
         napi_handle_scope scope = nullptr;
         napi_open_handle_scope(env_, &scope);
+        if (watcher_ != nullptr) {
+            watcher_(env_, reinterpret_cast<napi_value>(jsWindowNapiValue), info);
+            napi_close_handle_scope(env_, scope);
+            return;
+        }
         napi_value global = nullptr;
         napi_get_global(env_, &global);
         napi_value callback = nullptr;
@@ -154,21 +186,34 @@ public:
         env_ = env;
         callbackRef_ = callbackRef;
     }
+    /* destroyed windows go to the native watcher and never reach JS */
+    void SetEnvAndWatcher(napi_env env, NativeWindowWatcher watcher)
+    {
+        env_ = env;
+        watcher_ = watcher;
+    }
     void Reset()
     {
-        napi_delete_reference(env_, callbackRef_);
+        if (callbackRef_ != nullptr) {
+            napi_delete_reference(env_, callbackRef_);
+        }
         env_ = nullptr;
         callbackRef_ = nullptr;
+        watcher_ = nullptr;
     }
 private:
     napi_env env_ = nullptr;
     napi_ref callbackRef_ = nullptr;
+    NativeWindowWatcher watcher_ = nullptr;
 };
 
 std::shared_ptr<LeakWatcherEventHandler> GetTestHandler();
 bool TestCreateFile(const std::string& filePath);
 uint64_t TestGetFileSize(const std::string& filePath);
 bool TestAppendMetaData(const std::string& filePath);
+bool TestWatchLifecycleObject(napi_env env, napi_value weakRef);
+void TestFlushLifecycleBatch(napi_env env);
+LeakObjectRegistry& GetTestLeakRegistry();
 const uint64_t FDTAG = 0xD002D0B;
 
 #endif // JS_LEAK_WATCHER_NAPI_H
@@ -0,0 +1,471 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_rawheap.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+#include "hilog/log.h"
+#include "openssl/evp.h"
+#include "zlib.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD003D00
+#undef LOG_TAG
+#define LOG_TAG "JSLEAK_WATCHER_C"
+
+namespace {
+constexpr uint64_t RAWHEAP_FDTAG = 0xD002D0B;
+constexpr size_t COPY_BUFFER_SIZE = 16 * 1024;
+constexpr int FOOTER_FIELD_COUNT = 2;
+constexpr int REF_FOOTER_FIELD_COUNT = 3;
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+constexpr size_t HASH_HEX_LENGTH = 17;
+constexpr size_t DIGEST_BUFFER_SIZE = 256 * 1024;
+constexpr size_t HEX_CHARS_PER_BYTE = 2;
+constexpr size_t DIGEST_HEX_LENGTH = HEX_CHARS_PER_BYTE * EVP_MAX_MD_SIZE + 1;
+
+bool ReadFully(int fd, char* buff, size_t size, off_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = pread(fd, buff + done, size - done, offset + static_cast<off_t>(done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool WriteFully(int fd, const void* buff, size_t size, off_t offset)
+{
+    size_t done = 0;
+    while (done < size) {
+        ssize_t ret = pwrite(fd, static_cast<const char*>(buff) + done, size - done, offset + static_cast<off_t>(done));
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    return true;
+}
+
+bool CompressBlocks(int srcFd, uint64_t rawSize, int dstFd, uint32_t blockSize, RawHeapDigest* digest)
+{
+    std::vector<char> rawBlock(blockSize);
+    std::vector<Bytef> compressedBlock(compressBound(blockSize));
+    std::vector<RawHeapBlockIndex> index;
+    index.reserve(rawSize / blockSize + 1);
+    uint64_t writeOffset = 0;
+    for (uint64_t readOffset = 0; readOffset < rawSize; readOffset += blockSize) {
+        auto rawLen = static_cast<uint32_t>(std::min<uint64_t>(blockSize, rawSize - readOffset));
+        if (!ReadFully(srcFd, rawBlock.data(), rawLen, readOffset)) {
+            return false;
+        }
+        uLongf compressedLen = compressedBlock.size();
+        if (compress2(compressedBlock.data(), &compressedLen, reinterpret_cast<const Bytef*>(rawBlock.data()),
+            rawLen, Z_BEST_SPEED) != Z_OK || !WriteFully(dstFd, compressedBlock.data(), compressedLen, writeOffset)) {
+            return false;
+        }
+        if (digest != nullptr) {
+            digest->Update(compressedBlock.data(), compressedLen);
+        }
+        index.push_back({ writeOffset, static_cast<uint32_t>(compressedLen), rawLen });
+        writeOffset += compressedLen;
+    }
+    RawHeapCompressTrailer trailer = { RAWHEAP_COMPRESS_MAGIC, RAWHEAP_COMPRESS_VERSION, RAWHEAP_COMPRESS_ZLIB,
+        blockSize, static_cast<uint32_t>(index.size()), 0, rawSize, writeOffset };
+    size_t indexSize = index.size() * sizeof(RawHeapBlockIndex);
+    if (!WriteFully(dstFd, index.data(), indexSize, writeOffset) ||
+        !WriteFully(dstFd, &trailer, sizeof(trailer), writeOffset + indexSize)) {
+        return false;
+    }
+    if (digest != nullptr) {
+        digest->Update(index.data(), indexSize);
+        digest->Update(&trailer, sizeof(trailer));
+    }
+    return true;
+}
+}
+
+RawHeapDigest::RawHeapDigest()
+{
+    Reset();
+}
+
+RawHeapDigest::~RawHeapDigest()
+{
+    EVP_MD_CTX_free(ctx_);
+}
+
+void RawHeapDigest::Reset()
+{
+    if (ctx_ == nullptr) {
+        ctx_ = EVP_MD_CTX_new();
+    }
+    valid_ = ctx_ != nullptr && EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr) == 1;
+    size_ = 0;
+}
+
+bool RawHeapDigest::Update(const void* data, size_t size)
+{
+    if (!valid_) {
+        return false;
+    }
+    if (size > 0 && EVP_DigestUpdate(ctx_, data, size) != 1) {
+        valid_ = false;
+        return false;
+    }
+    size_ += size;
+    return true;
+}
+
+bool RawHeapDigest::UpdateFromFile(int fd, off_t offset, uint64_t size)
+{
+    std::vector<char> buff(static_cast<size_t>(std::min<uint64_t>(size, DIGEST_BUFFER_SIZE)));
+    uint64_t done = 0;
+    while (done < size) {
+        auto len = static_cast<size_t>(std::min<uint64_t>(buff.size(), size - done));
+        if (!ReadFully(fd, buff.data(), len, offset + static_cast<off_t>(done)) || !Update(buff.data(), len)) {
+            valid_ = false;
+            return false;
+        }
+        done += len;
+    }
+    return true;
+}
+
+uint64_t RawHeapDigest::Size() const
+{
+    return size_;
+}
+
+std::string RawHeapDigest::Final()
+{
+    char hex[DIGEST_HEX_LENGTH] = {0};
+    return Final(hex, sizeof(hex)) ? std::string(hex) : "";
+}
+
+bool RawHeapDigest::Final(char* hex, size_t size)
+{
+    unsigned char md[EVP_MAX_MD_SIZE];
+    unsigned int mdLen = 0;
+    if (hex == nullptr || size == 0) {
+        return false;
+    }
+    hex[0] = '\0';
+    if (!valid_ || EVP_DigestFinal_ex(ctx_, md, &mdLen) != 1) {
+        valid_ = false;
+        return false;
+    }
+    valid_ = false;
+    if (size < mdLen * HEX_CHARS_PER_BYTE + 1) {
+        return false;
+    }
+    for (unsigned int i = 0; i < mdLen; i++) {
+        size_t pos = i * HEX_CHARS_PER_BYTE;
+        if (snprintf(hex + pos, size - pos, "%02X", md[i]) < 0) {
+            hex[0] = '\0';
+            return false;
+        }
+    }
+    return true;
+}
+
+RawHeapMetaData::RawHeapMetaData(const std::string& metaDataPath) : metaDataPath_(metaDataPath)
+{
+}
+
+RawHeapMetaData::~RawHeapMetaData()
+{
+    if (metaDataFd_ >= 0) {
+        fdsan_close_with_tag(metaDataFd_, RAWHEAP_FDTAG);
+        metaDataFd_ = -1;
+    }
+}
+
+bool RawHeapMetaData::OpenMetaData()
+{
+    if (metaDataFd_ >= 0) {
+        return true;
+    }
+    int fd = open(metaDataPath_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        HILOG_ERROR(LOG_CORE, "open metadata failed, errno: %{public}d", errno);
+        return false;
+    }
+    fdsan_exchange_owner_tag(fd, 0, RAWHEAP_FDTAG);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size > UINT32_MAX) {
+        fdsan_close_with_tag(fd, RAWHEAP_FDTAG);
+        return false;
+    }
+    metaDataFd_ = fd;
+    metaDataSize_ = static_cast<uint32_t>(st.st_size);
+    return true;
+}
+
+bool RawHeapMetaData::HashMetaData()
+{
+    if (hashReady_) {
+        return true;
+    }
+    char buff[COPY_BUFFER_SIZE];
+    uint64_t hash = FNV_OFFSET_BASIS;
+    off_t readOffset = 0;
+    while (readOffset < static_cast<off_t>(metaDataSize_)) {
+        ssize_t readSize = pread(metaDataFd_, buff, sizeof(buff), readOffset);
+        if (readSize < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readSize <= 0) {
+            return false;
+        }
+        for (ssize_t i = 0; i < readSize; i++) {
+            hash = (hash ^ static_cast<unsigned char>(buff[i])) * FNV_PRIME;
+        }
+        readOffset += readSize;
+    }
+    contentHash_ = hash;
+    hashReady_ = true;
+    return true;
+}
+
+std::string RawHeapMetaData::GetSidecarPath(const std::string& filePath)
+{
+    char hashHex[HASH_HEX_LENGTH] = {0};
+    if (snprintf(hashHex, sizeof(hashHex), "%016" PRIx64, contentHash_) < 0) {
+        return "";
+    }
+    size_t pos = filePath.rfind('/');
+    std::string dir = pos == std::string::npos ? "." : filePath.substr(0, pos);
+    return dir + "/" + META_DATA_SIDECAR_PREFIX + hashHex + ".json";
+}
+
+bool RawHeapMetaData::WriteSidecar(const std::string& sidecarPath)
+{
+    if (access(sidecarPath.c_str(), F_OK) == 0) {
+        return true;
+    }
+    std::string tmpPath = sidecarPath + ".tmp";
+    const mode_t defaultMode = S_IRUSR | S_IWUSR | S_IRGRP; // -rw-r-----
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, defaultMode);
+    if (fd < 0) {
+        HILOG_ERROR(LOG_CORE, "create metadata sidecar failed, errno: %{public}d", errno);
+        return false;
+    }
+    fdsan_exchange_owner_tag(fd, 0, RAWHEAP_FDTAG);
+    bool ret = CopyMetaData(fd, 0);
+    fdsan_close_with_tag(fd, RAWHEAP_FDTAG);
+    if (!ret || rename(tmpPath.c_str(), sidecarPath.c_str()) != 0) {
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool RawHeapMetaData::CopyWithReadWrite(int targetFd, off_t targetOffset)
+{
+    char buff[COPY_BUFFER_SIZE];
+    off_t readOffset = 0;
+    while (readOffset < static_cast<off_t>(metaDataSize_)) {
+        ssize_t readSize = pread(metaDataFd_, buff, sizeof(buff), readOffset);
+        if (readSize < 0 && errno == EINTR) {
+            continue;
+        }
+        if (readSize <= 0) {
+            return false;
+        }
+        ssize_t written = 0;
+        while (written < readSize) {
+            ssize_t ret = pwrite(targetFd, buff + written, readSize - written, targetOffset + readOffset + written);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret <= 0) {
+                return false;
+            }
+            written += ret;
+        }
+        readOffset += readSize;
+    }
+    return true;
+}
+
+bool RawHeapMetaData::CopyMetaData(int targetFd, off_t targetOffset)
+{
+    loff_t srcOffset = 0;
+    loff_t dstOffset = targetOffset;
+    size_t remaining = metaDataSize_;
+    while (remaining > 0) {
+        ssize_t ret = copy_file_range(metaDataFd_, &srcOffset, targetFd, &dstOffset, remaining, 0);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            break;
+        }
+        remaining -= static_cast<size_t>(ret);
+    }
+    if (remaining == 0) {
+        return true;
+    }
+    // every fallback restarts from the beginning, rewriting what a partial copy left behind is harmless
+    off_t sendOffset = 0;
+    remaining = metaDataSize_;
+    if (lseek(targetFd, targetOffset, SEEK_SET) == targetOffset) {
+        while (remaining > 0) {
+            ssize_t ret = sendfile(targetFd, metaDataFd_, &sendOffset, remaining);
+            if (ret < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ret <= 0) {
+                break;
+            }
+            remaining -= static_cast<size_t>(ret);
+        }
+        if (remaining == 0) {
+            return true;
+        }
+    }
+    return CopyWithReadWrite(targetFd, targetOffset);
+}
+
+bool RawHeapMetaData::Append(const std::string& filePath, RawHeapMetaDataMode mode, RawHeapDigest* digest)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!OpenMetaData()) {
+        return false;
+    }
+    bool useSidecar = mode == META_DATA_SIDECAR && HashMetaData() && WriteSidecar(GetSidecarPath(filePath));
+    int targetFd = open(filePath.c_str(), (digest != nullptr ? O_RDWR : O_WRONLY) | O_CLOEXEC);
+    if (targetFd < 0) {
+        HILOG_ERROR(LOG_CORE, "open rawheap failed, errno: %{public}d", errno);
+        return false;
+    }
+    fdsan_exchange_owner_tag(targetFd, 0, RAWHEAP_FDTAG);
+    struct stat st;
+    if (fstat(targetFd, &st) != 0) {
+        fdsan_close_with_tag(targetFd, RAWHEAP_FDTAG);
+        return false;
+    }
+    auto rawHeapFileSize = static_cast<uint32_t>(st.st_size);
+    uint32_t metaDataFileSize = 0;
+    bool ret = false;
+    if (useSidecar) {
+        RawHeapMetaDataRef ref = { META_DATA_REF_MAGIC, META_DATA_REF_VERSION, contentHash_, metaDataSize_, 0 };
+        metaDataFileSize = sizeof(ref);
+        struct iovec footer[REF_FOOTER_FIELD_COUNT] = {
+            { &ref, sizeof(ref) },
+            { &rawHeapFileSize, sizeof(rawHeapFileSize) },
+            { &metaDataFileSize, sizeof(metaDataFileSize) },
+        };
+        ssize_t footerSize = static_cast<ssize_t>(sizeof(ref) + sizeof(rawHeapFileSize) + sizeof(metaDataFileSize));
+        ret = pwritev(targetFd, footer, REF_FOOTER_FIELD_COUNT, st.st_size) == footerSize;
+        if (ret && digest != nullptr && digest->UpdateFromFile(targetFd, digest->Size(), st.st_size - digest->Size())) {
+            digest->Update(&ref, sizeof(ref));
+            digest->Update(&rawHeapFileSize, sizeof(rawHeapFileSize));
+            digest->Update(&metaDataFileSize, sizeof(metaDataFileSize));
+        }
+    } else if (CopyMetaData(targetFd, st.st_size)) {
+        metaDataFileSize = metaDataSize_;
+        struct iovec footer[FOOTER_FIELD_COUNT] = {
+            { &rawHeapFileSize, sizeof(rawHeapFileSize) },
+            { &metaDataFileSize, sizeof(metaDataFileSize) },
+        };
+        ssize_t footerSize = static_cast<ssize_t>(sizeof(rawHeapFileSize) + sizeof(metaDataFileSize));
+        ret = pwritev(targetFd, footer, FOOTER_FIELD_COUNT, st.st_size + metaDataSize_) == footerSize;
+        // the metadata was copied inside the kernel, it is read back from the cached metadata file instead
+        if (ret && digest != nullptr && digest->UpdateFromFile(targetFd, digest->Size(), st.st_size - digest->Size()) &&
+            digest->UpdateFromFile(metaDataFd_, 0, metaDataSize_)) {
+            digest->Update(&rawHeapFileSize, sizeof(rawHeapFileSize));
+            digest->Update(&metaDataFileSize, sizeof(metaDataFileSize));
+        }
+    }
+    if (!ret) {
+        HILOG_ERROR(LOG_CORE, "append metadata failed, errno: %{public}d", errno);
+    }
+    fdsan_close_with_tag(targetFd, RAWHEAP_FDTAG);
+    return ret;
+}
+
+bool CompressRawHeap(const std::string& filePath, uint32_t blockSize, RawHeapDigest* digest)
+{
+    if (blockSize == 0) {
+        return false;
+    }
+    int srcFd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (srcFd < 0) {
+        return false;
+    }
+    fdsan_exchange_owner_tag(srcFd, 0, RAWHEAP_FDTAG);
+    struct stat st;
+    if (fstat(srcFd, &st) != 0) {
+        fdsan_close_with_tag(srcFd, RAWHEAP_FDTAG);
+        return false;
+    }
+    std::string tmpPath = filePath + ".tmp";
+    int dstFd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & (S_IRWXU | S_IRWXG));
+    if (dstFd < 0) {
+        fdsan_close_with_tag(srcFd, RAWHEAP_FDTAG);
+        return false;
+    }
+    fdsan_exchange_owner_tag(dstFd, 0, RAWHEAP_FDTAG);
+    if (digest != nullptr) {
+        digest->Reset();
+    }
+    bool ret = CompressBlocks(srcFd, static_cast<uint64_t>(st.st_size), dstFd, blockSize, digest);
+    fdsan_close_with_tag(dstFd, RAWHEAP_FDTAG);
+    fdsan_close_with_tag(srcFd, RAWHEAP_FDTAG);
+    if (!ret || rename(tmpPath.c_str(), filePath.c_str()) != 0) {
+        HILOG_ERROR(LOG_CORE, "compress rawheap failed, errno: %{public}d", errno);
+        unlink(tmpPath.c_str());
+        if (digest != nullptr) {
+            digest->Reset();
+        }
+        return false;
+    }
+    return true;
+}
+
+std::string GetFileSHA256(const std::string& filePath)
+{
+    int fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return "";
+    }
+    fdsan_exchange_owner_tag(fd, 0, RAWHEAP_FDTAG);
+    struct stat st;
+    RawHeapDigest digest;
+    bool ret = fstat(fd, &st) == 0 && digest.UpdateFromFile(fd, 0, static_cast<uint64_t>(st.st_size));
+    fdsan_close_with_tag(fd, RAWHEAP_FDTAG);
+    return ret ? digest.Final() : "";
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_RAWHEAP_H
+#define JS_LEAK_WATCHER_RAWHEAP_H
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+
+struct evp_md_ctx_st;
+
+/*
+ * SHA-256 of a rawheap file, fed by the passes that write it after the runtime finished the dump.
+ * Size() tells how many leading bytes have been digested so the next pass only reads what it has not seen.
+ */
+class RawHeapDigest {
+public:
+    RawHeapDigest();
+    ~RawHeapDigest();
+    RawHeapDigest(const RawHeapDigest&) = delete;
+    RawHeapDigest& operator = (const RawHeapDigest&) = delete;
+
+    bool Update(const void* data, size_t size);
+    bool UpdateFromFile(int fd, off_t offset, uint64_t size);
+    uint64_t Size() const;
+    void Reset();
+    /* upper case hex, empty when any update failed */
+    std::string Final();
+    /* same as Final into a caller buffer, false when any update failed or hex is too small */
+    bool Final(char* hex, size_t size);
+
+private:
+    evp_md_ctx_st* ctx_ = nullptr;
+    uint64_t size_ = 0;
+    bool valid_ = false;
+};
+
+enum RawHeapMetaDataMode : uint8_t {
+    META_DATA_INLINE = 0,
+    META_DATA_SIDECAR
+};
+
+/*
+ * Written instead of the metadata bytes in sidecar mode, the footer then carries sizeof(RawHeapMetaDataRef)
+ * as metaDataSize. The bytes themselves live once per directory in META_DATA_SIDECAR_PREFIX<hash>.json.
+ */
+struct RawHeapMetaDataRef {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t contentHash;
+    uint32_t metaDataSize;
+    uint32_t reserved;
+};
+static_assert(sizeof(RawHeapMetaDataRef) == 24, "RawHeapMetaDataRef is part of the rawheap format");
+
+constexpr uint32_t META_DATA_REF_MAGIC = 0x524D4C4A; // "JLMR"
+constexpr uint32_t META_DATA_REF_VERSION = 1;
+constexpr const char* META_DATA_SIDECAR_PREFIX = "jsleakwatcher_metadata_";
+
+/*
+ * Appends the arkcompiler metadata and the {rawHeapSize, metaDataSize} footer to a rawheap file.
+ * The metadata file is opened once and kept for the life of the process; its bytes are copied inside
+ * the kernel with copy_file_range, then sendfile, and only fall back to pread/pwrite when neither works.
+ */
+class RawHeapMetaData {
+public:
+    explicit RawHeapMetaData(const std::string& metaDataPath);
+    ~RawHeapMetaData();
+    RawHeapMetaData(const RawHeapMetaData&) = delete;
+    RawHeapMetaData& operator = (const RawHeapMetaData&) = delete;
+
+    bool Append(const std::string& filePath, RawHeapMetaDataMode mode = META_DATA_INLINE,
+        RawHeapDigest* digest = nullptr);
+    std::string GetSidecarPath(const std::string& filePath);
+
+private:
+    bool OpenMetaData();
+    bool HashMetaData();
+    bool WriteSidecar(const std::string& sidecarPath);
+    bool CopyMetaData(int targetFd, off_t targetOffset);
+    bool CopyWithReadWrite(int targetFd, off_t targetOffset);
+
+    std::mutex lock_;
+    std::string metaDataPath_;
+    int metaDataFd_ = -1;
+    uint32_t metaDataSize_ = 0;
+    uint64_t contentHash_ = 0;
+    bool hashReady_ = false;
+};
+
+/*
+ * A compressed rawheap body is a run of independently deflated blocks followed by the block index and
+ * RawHeapCompressTrailer, so the trailer sits right before the metadata and an analyzer can seek to any
+ * block without inflating the ones before it.
+ */
+struct RawHeapBlockIndex {
+    uint64_t offset;
+    uint32_t compressedSize;
+    uint32_t rawSize;
+};
+static_assert(sizeof(RawHeapBlockIndex) == 16, "RawHeapBlockIndex is part of the rawheap format");
+
+struct RawHeapCompressTrailer {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t algorithm;
+    uint32_t blockSize;
+    uint32_t blockCount;
+    uint32_t reserved;
+    uint64_t rawSize;
+    uint64_t indexOffset;
+};
+static_assert(sizeof(RawHeapCompressTrailer) == 40, "RawHeapCompressTrailer is part of the rawheap format");
+
+constexpr uint32_t RAWHEAP_COMPRESS_MAGIC = 0x5A434C4A; // "JLCZ"
+constexpr uint32_t RAWHEAP_COMPRESS_VERSION = 1;
+constexpr uint32_t RAWHEAP_COMPRESS_ZLIB = 1;
+constexpr uint32_t RAWHEAP_COMPRESS_BLOCK_SIZE = 1024 * 1024;
+
+/* rewrites a finished dump in place as compressed blocks, must run before the metadata is appended */
+bool CompressRawHeap(const std::string& filePath, uint32_t blockSize = RAWHEAP_COMPRESS_BLOCK_SIZE,
+    RawHeapDigest* digest = nullptr);
+/* digests a whole file natively, for dumps that are not produced through RawHeapMetaData */
+std::string GetFileSHA256(const std::string& filePath);
+#endif // JS_LEAK_WATCHER_RAWHEAP_H
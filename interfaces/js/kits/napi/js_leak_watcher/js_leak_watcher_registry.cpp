@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_registry.h"
+
+#include <unordered_set>
+
+namespace {
+constexpr uint32_t INITIAL_CAPACITY = 64;
+constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+constexpr uint32_t HASH_MULTIPLIER = 0x9E3779B1;
+constexpr uint32_t LOAD_FACTOR_NUMERATOR = 3;
+constexpr uint32_t LOAD_FACTOR_DENOMINATOR = 4;
+}
+
+uint32_t StringPool::Acquire(std::string_view str)
+{
+    auto iter = index_.find(str);
+    if (iter != index_.end()) {
+        entries_[iter->second].refs++;
+        return iter->second;
+    }
+    uint32_t id = 0;
+    if (!freeIds_.empty()) {
+        id = freeIds_.back();
+        freeIds_.pop_back();
+    } else {
+        entries_.emplace_back();
+        id = static_cast<uint32_t>(entries_.size() - 1);
+    }
+    Entry& entry = entries_[id];
+    entry.str.assign(str.data(), str.size());
+    entry.refs = 1;
+    index_.emplace(std::string_view(entry.str), id);
+    return id;
+}
+
+void StringPool::Release(uint32_t id)
+{
+    if (id >= entries_.size() || entries_[id].refs == 0) {
+        return;
+    }
+    Entry& entry = entries_[id];
+    if (--entry.refs > 0) {
+        return;
+    }
+    index_.erase(std::string_view(entry.str));
+    entry.str.clear();
+    entry.str.shrink_to_fit();
+    freeIds_.push_back(id);
+}
+
+const std::string& StringPool::Get(uint32_t id) const
+{
+    static const std::string empty;
+    return id < entries_.size() ? entries_[id].str : empty;
+}
+
+uint32_t StringPool::Size() const
+{
+    return static_cast<uint32_t>(index_.size());
+}
+
+void StringPool::Clear()
+{
+    index_.clear();
+    entries_.clear();
+    freeIds_.clear();
+}
+
+LeakObjectRegistry::LeakObjectRegistry() : slots_(INITIAL_CAPACITY)
+{
+}
+
+uint32_t LeakObjectRegistry::Probe(uint32_t hash) const
+{
+    return (hash * HASH_MULTIPLIER) & static_cast<uint32_t>(slots_.size() - 1);
+}
+
+uint32_t LeakObjectRegistry::FindSlot(uint32_t hash) const
+{
+    uint32_t mask = static_cast<uint32_t>(slots_.size() - 1);
+    for (uint32_t index = Probe(hash), step = 0; step < slots_.size(); index = (index + 1) & mask, step++) {
+        const Slot& slot = slots_[index];
+        if (slot.state == SLOT_EMPTY) {
+            return INVALID_SLOT;
+        }
+        if (slot.state == SLOT_USED && slot.info.hash == hash) {
+            return index;
+        }
+    }
+    return INVALID_SLOT;
+}
+
+void LeakObjectRegistry::Rehash(uint32_t capacity)
+{
+    std::vector<Slot> oldSlots(capacity);
+    oldSlots.swap(slots_);
+    uint32_t mask = capacity - 1;
+    for (const Slot& slot : oldSlots) {
+        if (slot.state != SLOT_USED) {
+            continue;
+        }
+        uint32_t index = Probe(slot.info.hash);
+        while (slots_[index].state == SLOT_USED) {
+            index = (index + 1) & mask;
+        }
+        slots_[index] = slot;
+    }
+    deleted_ = 0;
+    generation_++;
+}
+
+bool LeakObjectRegistry::Add(uint32_t hash, std::string_view name, std::string_view msg, uint64_t timestamp)
+{
+    if (FindSlot(hash) != INVALID_SLOT) {
+        return false;
+    }
+    uint32_t capacity = static_cast<uint32_t>(slots_.size());
+    if ((size_ + deleted_ + 1) * LOAD_FACTOR_DENOMINATOR > capacity * LOAD_FACTOR_NUMERATOR) {
+        Rehash((size_ + 1) * 2 > capacity ? capacity * 2 : capacity);
+    }
+    uint32_t mask = static_cast<uint32_t>(slots_.size() - 1);
+    uint32_t index = Probe(hash);
+    while (slots_[index].state == SLOT_USED) {
+        index = (index + 1) & mask;
+    }
+    Slot& slot = slots_[index];
+    if (slot.state == SLOT_DELETED) {
+        deleted_--;
+    }
+    slot.state = SLOT_USED;
+    slot.info.hash = hash;
+    slot.info.nameId = strings_.Acquire(name);
+    slot.info.msgId = strings_.Acquire(msg);
+    slot.info.timestamp = timestamp;
+    size_++;
+    births_++;
+    return true;
+}
+
+bool LeakObjectRegistry::Remove(uint32_t hash)
+{
+    uint32_t index = FindSlot(hash);
+    if (index == INVALID_SLOT) {
+        return false;
+    }
+    Slot& slot = slots_[index];
+    strings_.Release(slot.info.nameId);
+    strings_.Release(slot.info.msgId);
+    slot.state = SLOT_DELETED;
+    size_--;
+    deleted_++;
+    deaths_++;
+    return true;
+}
+
+bool LeakObjectRegistry::Contains(uint32_t hash) const
+{
+    return FindSlot(hash) != INVALID_SLOT;
+}
+
+bool LeakObjectRegistry::Find(uint32_t hash, LeakObjectInfo& info) const
+{
+    uint32_t index = FindSlot(hash);
+    if (index == INVALID_SLOT) {
+        return false;
+    }
+    info = slots_[index].info;
+    return true;
+}
+
+uint32_t LeakObjectRegistry::Size() const
+{
+    return size_;
+}
+
+void LeakObjectRegistry::Clear()
+{
+    std::vector<Slot>(INITIAL_CAPACITY).swap(slots_);
+    strings_.Clear();
+    deaths_ += size_;
+    size_ = 0;
+    deleted_ = 0;
+    generation_++;
+}
+
+uint64_t LeakObjectRegistry::GetBirthCount() const
+{
+    return births_;
+}
+
+uint64_t LeakObjectRegistry::GetDeathCount() const
+{
+    return deaths_;
+}
+
+const std::string& LeakObjectRegistry::GetString(uint32_t id) const
+{
+    return strings_.Get(id);
+}
+
+void LeakObjectRegistry::CollectHashes(std::vector<uint32_t>& out) const
+{
+    out.clear();
+    out.reserve(size_);
+    for (const Slot& slot : slots_) {
+        if (slot.state == SLOT_USED) {
+            out.push_back(slot.info.hash);
+        }
+    }
+}
+
+void LeakObjectRegistry::ForEach(const std::function<void(const LeakObjectInfo&)>& visitor) const
+{
+    for (const Slot& slot : slots_) {
+        if (slot.state == SLOT_USED) {
+            visitor(slot.info);
+        }
+    }
+}
+
+void LeakObjectRegistry::ResetCursor()
+{
+    cursor_ = 0;
+    cursorGeneration_ = generation_;
+}
+
+bool LeakObjectRegistry::NextBatch(uint32_t maxCount, std::vector<LeakObjectInfo>& out)
+{
+    if (cursorGeneration_ != generation_) {
+        return false;
+    }
+    uint32_t count = 0;
+    while (cursor_ < slots_.size() && count < maxCount) {
+        const Slot& slot = slots_[cursor_++];
+        if (slot.state == SLOT_USED) {
+            out.push_back(slot.info);
+            count++;
+        }
+    }
+    return cursor_ < slots_.size();
+}
+
+void DiffLeakHashes(const std::vector<uint32_t>& before, const std::vector<uint32_t>& after, LeakListDiff& diff)
+{
+    diff.added.clear();
+    diff.removed.clear();
+    diff.persistent.clear();
+    std::unordered_set<uint32_t> beforeSet(before.begin(), before.end(), before.size());
+    std::unordered_set<uint32_t> afterSet(after.size());
+    for (uint32_t hash : after) {
+        if (!afterSet.insert(hash).second) {
+            continue;
+        }
+        if (beforeSet.count(hash) != 0) {
+            diff.persistent.push_back(hash);
+        } else {
+            diff.added.push_back(hash);
+        }
+    }
+    for (uint32_t hash : before) {
+        if (afterSet.count(hash) == 0 && beforeSet.erase(hash) != 0) {
+            diff.removed.push_back(hash);
+        }
+    }
+}
+
+bool IsSameLeakHashSet(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs)
+{
+    std::unordered_set<uint32_t> lhsSet(lhs.begin(), lhs.end(), lhs.size());
+    std::unordered_set<uint32_t> rhsSet(rhs.size());
+    for (uint32_t hash : rhs) {
+        if (lhsSet.count(hash) == 0) {
+            return false;
+        }
+        rhsSet.insert(hash);
+    }
+    return rhsSet.size() == lhsSet.size();
+}
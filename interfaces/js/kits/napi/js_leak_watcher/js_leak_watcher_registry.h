@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_REGISTRY_H
+#define JS_LEAK_WATCHER_REGISTRY_H
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class StringPool {
+public:
+    uint32_t Acquire(std::string_view str);
+    void Release(uint32_t id);
+    const std::string& Get(uint32_t id) const;
+    uint32_t Size() const;
+    void Clear();
+
+private:
+    struct Entry {
+        std::string str;
+        uint32_t refs = 0;
+    };
+    std::deque<Entry> entries_;
+    std::vector<uint32_t> freeIds_;
+    std::unordered_map<std::string_view, uint32_t> index_;
+};
+
+struct LeakObjectInfo {
+    uint32_t hash = 0;
+    uint32_t nameId = 0;
+    uint32_t msgId = 0;
+    /* wall clock milliseconds when the object was registered, 0 when unknown */
+    uint64_t timestamp = 0;
+};
+
+/*
+ * Watched objects keyed by their identity hash. Entries live in an open addressing table so that a
+ * watched object costs one fixed size slot, and names and messages are interned because most objects
+ * share the same few constructor names. All methods are expected to run on the JS thread.
+ */
+class LeakObjectRegistry {
+public:
+    LeakObjectRegistry();
+    bool Add(uint32_t hash, std::string_view name, std::string_view msg, uint64_t timestamp = 0);
+    bool Remove(uint32_t hash);
+    bool Contains(uint32_t hash) const;
+    bool Find(uint32_t hash, LeakObjectInfo& info) const;
+    uint32_t Size() const;
+    void Clear();
+    /* monotonic counts of added and removed entries, a scheduler compares them between ticks */
+    uint64_t GetBirthCount() const;
+    uint64_t GetDeathCount() const;
+    const std::string& GetString(uint32_t id) const;
+    void CollectHashes(std::vector<uint32_t>& out) const;
+    /* visits the live entries in table order without touching the incremental cursor */
+    void ForEach(const std::function<void(const LeakObjectInfo&)>& visitor) const;
+
+    /* restarts the incremental iteration over the live entries */
+    void ResetCursor();
+    /* appends at most maxCount entries, returns false once finished or when a rehash moved the entries */
+    bool NextBatch(uint32_t maxCount, std::vector<LeakObjectInfo>& out);
+
+private:
+    enum SlotState : uint8_t {
+        SLOT_EMPTY = 0,
+        SLOT_USED,
+        SLOT_DELETED
+    };
+    struct Slot {
+        LeakObjectInfo info;
+        SlotState state = SLOT_EMPTY;
+    };
+
+    uint32_t FindSlot(uint32_t hash) const;
+    uint32_t Probe(uint32_t hash) const;
+    void Rehash(uint32_t capacity);
+
+    std::vector<Slot> slots_;
+    uint32_t size_ = 0;
+    uint32_t deleted_ = 0;
+    uint32_t cursor_ = 0;
+    uint64_t generation_ = 0;
+    uint64_t cursorGeneration_ = 0;
+    uint64_t births_ = 0;
+    uint64_t deaths_ = 0;
+    StringPool strings_;
+};
+
+struct LeakListDiff {
+    std::vector<uint32_t> added;
+    std::vector<uint32_t> removed;
+    std::vector<uint32_t> persistent;
+};
+
+/* linear time diff of two hash lists, a hash repeated inside one list is reported once */
+void DiffLeakHashes(const std::vector<uint32_t>& before, const std::vector<uint32_t>& after, LeakListDiff& diff);
+bool IsSameLeakHashSet(const std::vector<uint32_t>& lhs, const std::vector<uint32_t>& rhs);
+#endif // JS_LEAK_WATCHER_REGISTRY_H
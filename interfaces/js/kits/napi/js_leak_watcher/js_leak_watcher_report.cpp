@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_report.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "hilog/log.h"
+#include "js_leak_watcher_leaklist.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD003D00
+#undef LOG_TAG
+#define LOG_TAG "JSLEAK_WATCHER_C"
+
+uint32_t BuildLeakClassSummary(const LeakObjectRegistry& registry, const std::vector<uint32_t>& hashes,
+    uint32_t topN, std::string& out)
+{
+    std::unordered_map<uint32_t, uint32_t> counts;
+    uint32_t total = 0;
+    LeakObjectInfo info;
+    for (uint32_t hash : hashes) {
+        if (registry.Find(hash, info)) {
+            counts[info.nameId]++;
+            total++;
+        }
+    }
+    std::vector<std::pair<uint32_t, uint32_t>> classes(counts.begin(), counts.end());
+    size_t top = std::min<size_t>(topN, classes.size());
+    std::partial_sort(classes.begin(), classes.begin() + top, classes.end(),
+        [&registry](const auto& lhs, const auto& rhs) {
+            if (lhs.second != rhs.second) {
+                return lhs.second > rhs.second;
+            }
+            return registry.GetString(lhs.first) < registry.GetString(rhs.first);
+        });
+    LeakListWriter writer(out);
+    writer.BeginArray();
+    for (size_t i = 0; i < top; i++) {
+        writer.AddClassCount(registry.GetString(classes[i].first), classes[i].second);
+    }
+    writer.EndArray();
+    return total;
+}
+
+LeakReportWorker::LeakReportWorker(EventWriter writer) : writer_(std::move(writer)) {}
+
+LeakReportWorker::~LeakReportWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        running_ = false;
+    }
+    cond_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void LeakReportWorker::Submit(LeakReport report)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    if (reports_.size() >= LEAK_REPORT_QUEUE_CAPACITY) {
+        reports_.pop_front();
+        dropped_++;
+    }
+    reports_.push_back(std::move(report));
+    if (!worker_.joinable()) {
+        running_ = true;
+        worker_ = std::thread([this] { WorkLoop(); });
+    }
+    cond_.notify_one();
+}
+
+void LeakReportWorker::WorkLoop()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        cond_.wait(lock, [this] { return !running_ || !reports_.empty(); });
+        if (reports_.empty()) {
+            break;
+        }
+        LeakReport report = std::move(reports_.front());
+        reports_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        int ret = writer_(report);
+        if (ret != 0) {
+            HILOG_ERROR(LOG_CORE, "hisysevent report failed! ret %{public}d.", ret);
+        }
+        lock.lock();
+        busy_ = false;
+        if (reports_.empty()) {
+            idleCond_.notify_all();
+        }
+    }
+}
+
+void LeakReportWorker::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    idleCond_.wait(lock, [this] { return reports_.empty() && !busy_; });
+}
+
+uint64_t LeakReportWorker::GetDroppedCount()
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    return dropped_;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_REPORT_H
+#define JS_LEAK_WATCHER_REPORT_H
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "js_leak_watcher_registry.h"
+
+constexpr uint32_t LEAK_REPORT_TOP_CLASSES = 10;
+constexpr size_t LEAK_REPORT_QUEUE_CAPACITY = 4;
+
+struct LeakReport {
+    int32_t pid = 0;
+    std::string happenTime;
+    std::string module;
+    /* top classes of the leaked objects, the full list is in the jsleaklist file */
+    std::string leakList;
+    std::string leakListPath;
+    int32_t leakObjectCount = 0;
+};
+
+/*
+ * [{"name":...,"count":...}] for the topN constructor names among hashes, most frequent first, returns the
+ * number of leaked objects found in the registry.
+ */
+uint32_t BuildLeakClassSummary(const LeakObjectRegistry& registry, const std::vector<uint32_t>& hashes,
+    uint32_t topN, std::string& out);
+
+/*
+ * Writes leak events on one worker thread so the JS thread only builds the report. Reports are written in
+ * submission order; once LEAK_REPORT_QUEUE_CAPACITY reports are waiting the oldest one is dropped, a later
+ * report of the same process supersedes it anyway.
+ */
+class LeakReportWorker {
+public:
+    using EventWriter = std::function<int(const LeakReport&)>;
+
+    explicit LeakReportWorker(EventWriter writer);
+    ~LeakReportWorker();
+    LeakReportWorker(const LeakReportWorker&) = delete;
+    LeakReportWorker& operator = (const LeakReportWorker&) = delete;
+
+    void Submit(LeakReport report);
+    void WaitIdle();
+    uint64_t GetDroppedCount();
+
+private:
+    void WorkLoop();
+
+    EventWriter writer_;
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::condition_variable idleCond_;
+    std::deque<LeakReport> reports_;
+    std::thread worker_;
+    uint64_t dropped_ = 0;
+    bool running_ = false;
+    bool busy_ = false;
+};
+#endif // JS_LEAK_WATCHER_REPORT_H
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_retention.h"
+
+#include <cerrno>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include "hilog/log.h"
+
+#undef LOG_DOMAIN
+#define LOG_DOMAIN 0xD003D00
+#undef LOG_TAG
+#define LOG_TAG "JSLEAK_WATCHER_C"
+
+namespace {
+constexpr const char* ARTIFACT_SUFFIXES[ARTIFACT_KIND_COUNT] = { ".jsleaklist", ".rawheap", ".heapsnapshot" };
+constexpr uint8_t ALL_ARTIFACT_KINDS = ARTIFACT_JSLEAKLIST | ARTIFACT_RAWHEAP | ARTIFACT_HEAPSNAPSHOT;
+constexpr uint64_t DECIMAL_BASE = 10;
+
+/* same rule as the file names written by js_leak_watcher.ts, the digits right before the suffix */
+uint64_t GetTimestamp(const std::string& baseName)
+{
+    size_t begin = baseName.size();
+    while (begin > 0 && baseName[begin - 1] >= '0' && baseName[begin - 1] <= '9') {
+        begin--;
+    }
+    uint64_t timestamp = 0;
+    for (size_t i = begin; i < baseName.size(); i++) {
+        timestamp = timestamp * DECIMAL_BASE + static_cast<uint64_t>(baseName[i] - '0');
+    }
+    return timestamp;
+}
+
+bool SplitFileName(const std::string& fileName, std::string& baseName, uint8_t& kind)
+{
+    for (uint32_t i = 0; i < ARTIFACT_KIND_COUNT; i++) {
+        std::string suffix = ARTIFACT_SUFFIXES[i];
+        if (fileName.size() > suffix.size() &&
+            fileName.compare(fileName.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            baseName = fileName.substr(0, fileName.size() - suffix.size());
+            kind = static_cast<uint8_t>(1U << i);
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+DumpRetentionManager::~DumpRetentionManager()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        running_ = false;
+    }
+    cond_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+void DumpRetentionManager::Post(std::function<void()> task)
+{
+    std::lock_guard<std::mutex> lock(lock_);
+    tasks_.push_back(std::move(task));
+    if (!worker_.joinable()) {
+        running_ = true;
+        worker_ = std::thread([this] { WorkLoop(); });
+    }
+    cond_.notify_one();
+}
+
+void DumpRetentionManager::WorkLoop()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    while (true) {
+        cond_.wait(lock, [this] { return !running_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+            break;
+        }
+        auto task = std::move(tasks_.front());
+        tasks_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> indexLock(indexLock_);
+            task();
+        }
+        lock.lock();
+        busy_ = false;
+        if (tasks_.empty()) {
+            idleCond_.notify_all();
+        }
+    }
+}
+
+void DumpRetentionManager::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    idleCond_.wait(lock, [this] { return tasks_.empty() && !busy_; });
+}
+
+void DumpRetentionManager::SetLimits(uint32_t maxDumps, uint64_t maxBytes)
+{
+    if (maxDumps == 0) {
+        return;
+    }
+    Post([this, maxDumps, maxBytes] {
+        maxDumps_ = maxDumps;
+        maxBytes_ = maxBytes;
+    });
+}
+
+void DumpRetentionManager::PrepareDump(const std::string& dir, const std::string& prefix, bool firstDump)
+{
+    bool firstPrepare = false;
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        firstPrepare = preparedDirs_.insert(dir).second;
+    }
+    Post([this, dir, prefix, firstDump] { DoPrepareDump(dir, prefix, firstDump); });
+    // the rawheap created right after this call has no jsleaklist yet, a later listing would take it for a leftover
+    if (firstDump || firstPrepare) {
+        WaitIdle();
+    }
+}
+
+void DumpRetentionManager::CommitDump(const std::string& dir, const std::string& baseName)
+{
+    Post([this, dir, baseName] { DoCommitDump(dir, baseName); });
+}
+
+void DumpRetentionManager::PinDump(const std::string& dir, const std::string& baseName)
+{
+    Post([this, dir, baseName] { GetIndex(dir).pinned = baseName; });
+}
+
+void DumpRetentionManager::LinkDelta(const std::string& dir, const std::string& deltaName,
+    const std::string& baseName)
+{
+    Post([this, dir, deltaName, baseName] {
+        DirectoryIndex& index = GetIndex(dir);
+        if (index.deltaBases.emplace(deltaName, baseName).second) {
+            index.deltaRefs[baseName]++;
+        }
+    });
+}
+
+uint32_t DumpRetentionManager::GetDumpCount(const std::string& dir)
+{
+    std::lock_guard<std::mutex> indexLock(indexLock_);
+    auto iter = indexes_.find(dir);
+    return iter == indexes_.end() ? 0 : static_cast<uint32_t>(iter->second.artifacts.size());
+}
+
+uint64_t DumpRetentionManager::GetTotalBytes(const std::string& dir)
+{
+    std::lock_guard<std::mutex> indexLock(indexLock_);
+    auto iter = indexes_.find(dir);
+    return iter == indexes_.end() ? 0 : iter->second.totalBytes;
+}
+
+DumpRetentionManager::DirectoryIndex& DumpRetentionManager::GetIndex(const std::string& dir)
+{
+    auto iter = indexes_.find(dir);
+    if (iter != indexes_.end()) {
+        return iter->second;
+    }
+    DirectoryIndex& index = indexes_[dir];
+    ScanDirectory(dir, index);
+    return index;
+}
+
+void DumpRetentionManager::ScanDirectory(const std::string& dir, DirectoryIndex& index)
+{
+    DIR* dirp = opendir(dir.c_str());
+    if (dirp == nullptr) {
+        HILOG_ERROR(LOG_CORE, "open dump dir failed, errno: %{public}d", errno);
+        return;
+    }
+    std::string baseName;
+    uint8_t kind = 0;
+    for (struct dirent* entry = readdir(dirp); entry != nullptr; entry = readdir(dirp)) {
+        bool isFile = entry->d_type == DT_REG || entry->d_type == DT_UNKNOWN;
+        if (isFile && SplitFileName(entry->d_name, baseName, kind)) {
+            RecordFile(dir, index, baseName, kind);
+        }
+    }
+    closedir(dirp);
+}
+
+void DumpRetentionManager::RecordFile(const std::string& dir, DirectoryIndex& index, const std::string& baseName,
+    uint8_t kind)
+{
+    uint32_t slot = 0;
+    while ((1U << slot) != kind) {
+        slot++;
+    }
+    struct stat st;
+    if (stat((dir + "/" + baseName + ARTIFACT_SUFFIXES[slot]).c_str(), &st) != 0) {
+        return;
+    }
+    Artifact& artifact = index.artifacts[ArtifactKey(GetTimestamp(baseName), baseName)];
+    index.totalBytes -= artifact.bytes[slot];
+    artifact.bytes[slot] = static_cast<uint64_t>(st.st_size);
+    artifact.kinds |= kind;
+    index.totalBytes += artifact.bytes[slot];
+}
+
+bool DumpRetentionManager::IsHeld(const DirectoryIndex& index, const std::string& baseName)
+{
+    return baseName == index.pinned || index.deltaRefs.count(baseName) != 0;
+}
+
+void DumpRetentionManager::ReleaseDelta(DirectoryIndex& index, const std::string& deltaName)
+{
+    auto iter = index.deltaBases.find(deltaName);
+    if (iter == index.deltaBases.end()) {
+        return;
+    }
+    auto ref = index.deltaRefs.find(iter->second);
+    if (ref != index.deltaRefs.end() && --ref->second == 0) {
+        index.deltaRefs.erase(ref);
+    }
+    index.deltaBases.erase(iter);
+}
+
+void DumpRetentionManager::RemoveKinds(const std::string& dir, DirectoryIndex& index, const ArtifactKey& key,
+    uint8_t kinds)
+{
+    auto iter = index.artifacts.find(key);
+    if (iter == index.artifacts.end()) {
+        return;
+    }
+    Artifact& artifact = iter->second;
+    for (uint32_t slot = 0; slot < ARTIFACT_KIND_COUNT; slot++) {
+        uint8_t kind = static_cast<uint8_t>(1U << slot);
+        if ((kinds & artifact.kinds & kind) == 0) {
+            continue;
+        }
+        std::string path = dir + "/" + key.second + ARTIFACT_SUFFIXES[slot];
+        if (unlink(path.c_str()) != 0 && errno != ENOENT) {
+            HILOG_ERROR(LOG_CORE, "delete dump file failed, errno: %{public}d", errno);
+            continue;
+        }
+        index.totalBytes -= artifact.bytes[slot];
+        artifact.bytes[slot] = 0;
+        artifact.kinds &= static_cast<uint8_t>(~kind);
+        if (kind == ARTIFACT_RAWHEAP) {
+            ReleaseDelta(index, key.second);
+        }
+    }
+    if (artifact.kinds == 0) {
+        index.artifacts.erase(iter);
+    }
+}
+
+void DumpRetentionManager::DoPrepareDump(const std::string& dir, const std::string& prefix, bool firstDump)
+{
+    DirectoryIndex& index = GetIndex(dir);
+    if (firstDump) {
+        std::vector<ArtifactKey> unmatched;
+        for (const auto& [key, artifact] : index.artifacts) {
+            if ((artifact.kinds & ARTIFACT_RAWHEAP) != 0 && (artifact.kinds & ARTIFACT_JSLEAKLIST) == 0) {
+                unmatched.push_back(key);
+            }
+        }
+        for (const auto& key : unmatched) {
+            RemoveKinds(dir, index, key, ARTIFACT_RAWHEAP);
+        }
+        return;
+    }
+    for (auto iter = index.artifacts.rbegin(); iter != index.artifacts.rend(); ++iter) {
+        if ((iter->second.kinds & ARTIFACT_JSLEAKLIST) == 0) {
+            continue;
+        }
+        if (iter->first.second.compare(0, prefix.size(), prefix) == 0 && !IsHeld(index, iter->first.second)) {
+            ArtifactKey key = iter->first;
+            RemoveKinds(dir, index, key, ALL_ARTIFACT_KINDS);
+        }
+        return;
+    }
+}
+
+void DumpRetentionManager::DoCommitDump(const std::string& dir, const std::string& baseName)
+{
+    DirectoryIndex& index = GetIndex(dir);
+    for (uint32_t slot = 0; slot < ARTIFACT_KIND_COUNT; slot++) {
+        RecordFile(dir, index, baseName, static_cast<uint8_t>(1U << slot));
+    }
+    while (!index.artifacts.empty()) {
+        // bases still needed by a delta, the pinned one included, do not count against the dump limit
+        size_t removable = 0;
+        auto iter = index.artifacts.end();
+        for (auto candidate = index.artifacts.begin(); candidate != index.artifacts.end(); ++candidate) {
+            if (IsHeld(index, candidate->first.second)) {
+                continue;
+            }
+            removable++;
+            if (iter == index.artifacts.end()) {
+                iter = candidate;
+            }
+        }
+        bool overCount = removable > maxDumps_;
+        bool overBytes = maxBytes_ != 0 && index.totalBytes > maxBytes_ && removable > 1;
+        if (iter == index.artifacts.end() || (!overCount && !overBytes)) {
+            break;
+        }
+        ArtifactKey oldest = iter->first;
+        size_t before = index.artifacts.size();
+        RemoveKinds(dir, index, oldest, ALL_ARTIFACT_KINDS);
+        if (index.artifacts.size() == before) {
+            break;
+        }
+    }
+}
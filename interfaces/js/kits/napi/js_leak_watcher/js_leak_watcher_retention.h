@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_RETENTION_H
+#define JS_LEAK_WATCHER_RETENTION_H
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+enum DumpArtifactKind : uint8_t {
+    ARTIFACT_JSLEAKLIST = 1 << 0,
+    ARTIFACT_RAWHEAP = 1 << 1,
+    ARTIFACT_HEAPSNAPSHOT = 1 << 2
+};
+constexpr uint32_t ARTIFACT_KIND_COUNT = 3;
+
+/*
+ * Keeps the dump artifacts of each directory in memory, oldest first, so that retention never lists the
+ * directory again after it was first seen. Every public call queues a task; listing, stat and unlink
+ * run in order on one worker thread, so a dump that is prepared before it is committed is handled in the
+ * same order the JS side issued the calls. Only the first prepare of a directory waits for its task, the
+ * listing must not see the files of the dump the caller is about to create.
+ */
+class DumpRetentionManager {
+public:
+    DumpRetentionManager() = default;
+    ~DumpRetentionManager();
+    DumpRetentionManager(const DumpRetentionManager&) = delete;
+    DumpRetentionManager& operator = (const DumpRetentionManager&) = delete;
+
+    /* maxBytes 0 disables the byte quota, the newest dump is never removed to satisfy it */
+    void SetLimits(uint32_t maxDumps, uint64_t maxBytes);
+    /*
+     * drops rawheaps without a jsleaklist on the first dump, otherwise the previous dump of this process,
+     * returns once dir is indexed when this is the first dump or the first prepare of dir
+     */
+    void PrepareDump(const std::string& dir, const std::string& prefix, bool firstDump);
+    /* records the files of a finished dump and removes the oldest dumps over the limits */
+    void CommitDump(const std::string& dir, const std::string& baseName);
+    /* keeps the base of the delta dumps in dir out of both removal rules and the count, empty unpins */
+    void PinDump(const std::string& dir, const std::string& baseName);
+    /* records that deltaName was written against baseName, the base is kept like a pinned one while the delta is */
+    void LinkDelta(const std::string& dir, const std::string& deltaName, const std::string& baseName);
+    void WaitIdle();
+    /* diagnostics only, they wait for the task the worker is running */
+    uint32_t GetDumpCount(const std::string& dir);
+    uint64_t GetTotalBytes(const std::string& dir);
+
+private:
+    struct Artifact {
+        uint8_t kinds = 0;
+        uint64_t bytes[ARTIFACT_KIND_COUNT] = {0};
+    };
+    using ArtifactKey = std::pair<uint64_t, std::string>;
+    struct DirectoryIndex {
+        std::map<ArtifactKey, Artifact> artifacts;
+        uint64_t totalBytes = 0;
+        std::string pinned;
+        std::unordered_map<std::string, std::string> deltaBases;
+        std::unordered_map<std::string, uint32_t> deltaRefs;
+    };
+
+    void Post(std::function<void()> task);
+    void WorkLoop();
+    DirectoryIndex& GetIndex(const std::string& dir);
+    void ScanDirectory(const std::string& dir, DirectoryIndex& index);
+    void RecordFile(const std::string& dir, DirectoryIndex& index, const std::string& baseName, uint8_t kind);
+    void RemoveKinds(const std::string& dir, DirectoryIndex& index, const ArtifactKey& key, uint8_t kinds);
+    static bool IsHeld(const DirectoryIndex& index, const std::string& baseName);
+    static void ReleaseDelta(DirectoryIndex& index, const std::string& deltaName);
+    void DoPrepareDump(const std::string& dir, const std::string& prefix, bool firstDump);
+    void DoCommitDump(const std::string& dir, const std::string& baseName);
+
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::condition_variable idleCond_;
+    std::deque<std::function<void()>> tasks_;
+    std::thread worker_;
+    bool running_ = false;
+    bool busy_ = false;
+    std::unordered_set<std::string> preparedDirs_;
+
+    std::mutex indexLock_;
+    uint32_t maxDumps_ = 10;
+    uint64_t maxBytes_ = 0;
+    std::unordered_map<std::string, DirectoryIndex> indexes_;
+};
+#endif // JS_LEAK_WATCHER_RETENTION_H
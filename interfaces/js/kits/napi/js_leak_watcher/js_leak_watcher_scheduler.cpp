@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "js_leak_watcher_scheduler.h"
+
+#include <algorithm>
+
+void LeakWatcherScheduler::SetMaxInterval(uint32_t intervalMs)
+{
+    maxIntervalMs_ = intervalMs;
+    intervalMs_ = maxIntervalMs_;
+}
+
+uint32_t LeakWatcherScheduler::GetMaxInterval() const
+{
+    return maxIntervalMs_;
+}
+
+uint32_t LeakWatcherScheduler::GetInterval() const
+{
+    return intervalMs_;
+}
+
+uint32_t LeakWatcherScheduler::GetMinInterval() const
+{
+    return maxIntervalMs_ / GC_INTERVAL_TIGHTEN_LIMIT;
+}
+
+void LeakWatcherScheduler::BackOff()
+{
+    intervalMs_ = static_cast<uint32_t>(std::min<uint64_t>(static_cast<uint64_t>(intervalMs_) * 2, maxIntervalMs_));
+}
+
+bool LeakWatcherScheduler::OnTick(uint64_t births, uint64_t deaths, uint32_t liveCount)
+{
+    if (hasRun_ && births == lastBirths_ && deaths == lastDeaths_) {
+        BackOff();
+        return false;
+    }
+    if (hasRun_ && liveCount > lastLiveCount_) {
+        intervalMs_ = std::max(intervalMs_ / 2, GetMinInterval());
+    } else {
+        BackOff();
+    }
+    lastBirths_ = births;
+    lastDeaths_ = deaths;
+    lastLiveCount_ = liveCount;
+    hasRun_ = true;
+    return true;
+}
+
+void LeakWatcherScheduler::Reset()
+{
+    intervalMs_ = maxIntervalMs_;
+    lastBirths_ = 0;
+    lastDeaths_ = 0;
+    lastLiveCount_ = 0;
+    hasRun_ = false;
+}
+
+void LeakThresholdGate::SetThresholds(uint32_t fgThreshold, uint32_t bgThreshold)
+{
+    fgThreshold_ = fgThreshold;
+    bgThreshold_ = bgThreshold;
+    hasThresholds_ = true;
+}
+
+void LeakThresholdGate::SetAppState(int32_t state)
+{
+    appState_ = state;
+}
+
+int32_t LeakThresholdGate::GetAppState() const
+{
+    return appState_;
+}
+
+void LeakThresholdGate::SetRetryPending(bool pending)
+{
+    retryPending_ = pending;
+}
+
+bool LeakThresholdGate::IsBelowThreshold(uint32_t liveCount) const
+{
+    if (!hasThresholds_ || retryPending_) {
+        return false;
+    }
+    if (appState_ == APP_STATE_FOREGROUND) {
+        return liveCount < fgThreshold_;
+    }
+    if (appState_ == APP_STATE_BACKGROUND) {
+        return liveCount < bgThreshold_;
+    }
+    return false;
+}
+
+void LeakThresholdGate::Reset()
+{
+    fgThreshold_ = 0;
+    bgThreshold_ = 0;
+    hasThresholds_ = false;
+    retryPending_ = false;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef JS_LEAK_WATCHER_SCHEDULER_H
+#define JS_LEAK_WATCHER_SCHEDULER_H
+#include <cstdint>
+
+constexpr uint32_t DEFAULT_GC_INTERVAL = 90000; // 90s
+constexpr uint32_t GC_INTERVAL_TIGHTEN_LIMIT = 8;
+constexpr int32_t APP_STATE_UNKNOWN = -1;
+constexpr int32_t APP_STATE_FOREGROUND = 1;
+constexpr int32_t APP_STATE_BACKGROUND = 3;
+
+/*
+ * Decides on each GC tick whether the full GC and the following dump are worth running. A tick is skipped
+ * when no watched object was registered or collected since the last GC, because a GC could not change the
+ * leak list then. The interval doubles while the leak set is stable and halves when it grows, staying
+ * between maxInterval / GC_INTERVAL_TIGHTEN_LIMIT and the configured check interval.
+ */
+class LeakWatcherScheduler {
+public:
+    void SetMaxInterval(uint32_t intervalMs);
+    uint32_t GetMaxInterval() const;
+    uint32_t GetInterval() const;
+    bool OnTick(uint64_t births, uint64_t deaths, uint32_t liveCount);
+    void Reset();
+
+private:
+    uint32_t GetMinInterval() const;
+    void BackOff();
+
+    uint32_t maxIntervalMs_ = DEFAULT_GC_INTERVAL;
+    uint32_t intervalMs_ = DEFAULT_GC_INTERVAL;
+    uint64_t lastBirths_ = 0;
+    uint64_t lastDeaths_ = 0;
+    uint32_t lastLiveCount_ = 0;
+    bool hasRun_ = false;
+};
+
+/*
+ * Foreground and background leak count thresholds of the config object, checked against the live count
+ * of the registry and the application state cached from the state change callbacks, so a GC tick below
+ * the threshold is dropped without entering JS. Nothing is gated until both thresholds and state are known.
+ */
+class LeakThresholdGate {
+public:
+    void SetThresholds(uint32_t fgThreshold, uint32_t bgThreshold);
+    void SetAppState(int32_t state);
+    int32_t GetAppState() const;
+    /* JS still has monitor registrations to retry on the next GC tick */
+    void SetRetryPending(bool pending);
+    bool IsBelowThreshold(uint32_t liveCount) const;
+    void Reset();
+
+private:
+    uint32_t fgThreshold_ = 0;
+    uint32_t bgThreshold_ = 0;
+    int32_t appState_ = APP_STATE_UNKNOWN;
+    bool hasThresholds_ = false;
+    bool retryPending_ = false;
+};
+#endif // JS_LEAK_WATCHER_SCHEDULER_H
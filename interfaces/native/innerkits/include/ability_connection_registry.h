@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HIVIEWDFX_ABILITY_CONNECTION_REGISTRY_H
+#define HIVIEWDFX_ABILITY_CONNECTION_REGISTRY_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace OHOS {
+namespace HiviewDFX {
+using ConnectionHandle = uint64_t;
+constexpr ConnectionHandle INVALID_CONNECTION_HANDLE = 0;
+
+/*
+ * Process wide registry of ability connections. A handle packs the slot index with the slot generation,
+ * so a stale handle is rejected in O(1) once its slot has been reused. Connections of the same owner are
+ * chained through the slots themselves. Released slots, owners without connections and targets no longer
+ * referenced are recycled through free lists, so memory only grows with the peak number of live connections.
+ */
+class AbilityConnectionRegistry {
+public:
+    static AbilityConnectionRegistry& GetInstance();
+    AbilityConnectionRegistry(const AbilityConnectionRegistry&) = delete;
+    AbilityConnectionRegistry& operator = (const AbilityConnectionRegistry&) = delete;
+
+    ConnectionHandle Connect(uint64_t ownerId, const std::string& ownerName, const std::string& target);
+    ConnectionHandle Connect(uint64_t ownerId, const std::string& ownerName, const std::string& target,
+        uint64_t nowMs);
+    bool Disconnect(ConnectionHandle handle);
+    uint32_t DisconnectOwner(uint64_t ownerId);
+    uint32_t GetConnectionCount() const;
+    uint32_t GetOwnerConnectionCount(uint64_t ownerId) const;
+    /* owners and targets that still have live connections */
+    uint32_t GetOwnerCount() const;
+    uint32_t GetTargetCount() const;
+
+    void SetLeakThreshold(uint64_t thresholdMs);
+    /* checks at most maxSlots slots from where the previous step stopped, returns the leaks reported */
+    uint32_t ScanStep(uint64_t nowMs, uint32_t maxSlots);
+    bool StartAgeScan(uint32_t intervalMs, uint32_t slotsPerStep);
+    void StopAgeScan();
+    void Reset();
+
+private:
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    struct Slot {
+        uint64_t connectTimeMs = 0;
+        uint32_t generation = 1;
+        uint32_t ownerIndex = INVALID_INDEX;
+        uint32_t targetId = 0;
+        uint32_t prev = INVALID_INDEX;
+        uint32_t next = INVALID_INDEX;
+        bool inUse = false;
+        bool reported = false;
+    };
+
+    struct Owner {
+        uint64_t ownerId = 0;
+        std::string name;
+        uint32_t head = INVALID_INDEX;
+        uint32_t count = 0;
+    };
+
+    struct Target {
+        std::string name;
+        uint32_t refs = 0;
+    };
+
+    struct LeakRecord {
+        uint32_t ownerIndex;
+        uint32_t targetId;
+        uint64_t ageMs;
+    };
+
+    AbilityConnectionRegistry() = default;
+    ~AbilityConnectionRegistry();
+    uint32_t AcquireSlot();
+    void ReleaseSlot(uint32_t index);
+    uint32_t GetOrCreateOwner(uint64_t ownerId, const std::string& ownerName);
+    void ReleaseOwner(uint32_t index);
+    uint32_t InternTarget(const std::string& target);
+    void ReleaseTarget(uint32_t id);
+    void ScanLoop(uint32_t intervalMs, uint32_t slotsPerStep);
+    static uint64_t GetNowMs();
+
+    mutable std::mutex lock_;
+    std::vector<Slot> slots_;
+    uint32_t freeHead_ = INVALID_INDEX;
+    uint32_t liveCount_ = 0;
+    std::vector<Owner> owners_;
+    std::unordered_map<uint64_t, uint32_t> ownerIndex_;
+    std::vector<uint32_t> freeOwners_;
+    std::vector<Target> targets_;
+    std::unordered_map<std::string, uint32_t> targetIndex_;
+    std::vector<uint32_t> freeTargets_;
+    uint64_t leakThresholdMs_ = 60000; // 60s
+    uint32_t scanCursor_ = 0;
+
+    std::mutex scanLock_;
+    std::condition_variable scanCond_;
+    std::thread scanThread_;
+    bool scanRunning_ = false;
+    /* set while StopAgeScan joins the scan thread, a start is rejected until the join is done */
+    bool scanStopping_ = false;
+};
+} // HiviewDFX
+} // OHOS
+#endif // HIVIEWDFX_ABILITY_CONNECTION_REGISTRY_H
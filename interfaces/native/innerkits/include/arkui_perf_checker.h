@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HIVIEWDFX_ARKUI_PERF_CHECKER_H
+#define HIVIEWDFX_ARKUI_PERF_CHECKER_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace OHOS {
+namespace HiviewDFX {
+enum ArkUIFramePhase : uint32_t {
+    ARKUI_PHASE_BUILD = 0,
+    ARKUI_PHASE_LAYOUT,
+    ARKUI_PHASE_RENDER,
+    ARKUI_PHASE_COUNT
+};
+
+struct ArkUIFrameTiming {
+    uint64_t frameId = 0;
+    uint32_t phaseCostUs[ARKUI_PHASE_COUNT] = { 0 };
+};
+
+/*
+ * Single producer single consumer ring buffer. The producer only writes tail_ and the consumer only
+ * writes head_, so neither side ever takes a lock or allocates.
+ */
+template<typename T, uint32_t CAPACITY>
+class SpscQueue {
+    static_assert(CAPACITY != 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+public:
+    bool Push(const T& item)
+    {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == CAPACITY) {
+            return false;
+        }
+        items_[tail & (CAPACITY - 1)] = item;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Pop(T& item)
+    {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items_[head & (CAPACITY - 1)];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> head_ { 0 };
+    alignas(64) std::atomic<uint32_t> tail_ { 0 };
+    alignas(64) T items_[CAPACITY];
+};
+
+class ArkUIPerfChecker {
+public:
+    static constexpr uint32_t QUEUE_CAPACITY = 256;
+    static constexpr uint32_t MAX_WINDOW_SIZE = 128;
+
+    static ArkUIPerfChecker& GetInstance();
+    ArkUIPerfChecker(const ArkUIPerfChecker&) = delete;
+    ArkUIPerfChecker& operator = (const ArkUIPerfChecker&) = delete;
+
+    /* called by the ArkUI pipeline once per frame, returns false when the frame was dropped */
+    bool ReportFrame(const ArkUIFrameTiming& timing);
+    /* called from the event loop of the consumer thread, returns the number of frames analyzed */
+    uint32_t ProcessPendingFrames();
+
+    void SetPhaseBudget(ArkUIFramePhase phase, uint32_t budgetUs);
+    uint32_t GetPhaseBudget(ArkUIFramePhase phase) const;
+    bool SetViolationWindow(uint32_t violationCount, uint32_t windowSize);
+    uint32_t GetPhasePercentile(ArkUIFramePhase phase, uint32_t percentile) const;
+    uint64_t GetDroppedFrameCount() const;
+    uint64_t GetCautionCount() const;
+    void Reset();
+
+private:
+    struct PhaseWindow {
+        uint32_t costUs[MAX_WINDOW_SIZE] = { 0 };
+        bool overBudget[MAX_WINDOW_SIZE] = { false };
+        uint32_t sampleCount = 0;
+        uint32_t violationCount = 0;
+    };
+
+    ArkUIPerfChecker();
+    ~ArkUIPerfChecker() = default;
+    void AnalyzeFrame(const ArkUIFrameTiming& timing, bool checkEnabled);
+    uint32_t CalcPercentile(const PhaseWindow& window, uint32_t percentile) const;
+    void RaiseCaution(ArkUIFramePhase phase, uint64_t frameId);
+
+    SpscQueue<ArkUIFrameTiming, QUEUE_CAPACITY> frameQueue_;
+    std::atomic<uint64_t> droppedFrames_ { 0 };
+
+    mutable std::mutex windowLock_;
+    PhaseWindow windows_[ARKUI_PHASE_COUNT];
+    uint32_t phaseBudgetUs_[ARKUI_PHASE_COUNT];
+    uint32_t violationThreshold_;
+    uint32_t windowSize_;
+    uint32_t cursor_ = 0;
+    uint64_t cautionCount_ = 0;
+};
+} // HiviewDFX
+} // OHOS
+#endif // HIVIEWDFX_ARKUI_PERF_CHECKER_H
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HIVIEWDFX_HICHECKER_PARAM_CACHE_H
+#define HIVIEWDFX_HICHECKER_PARAM_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace OHOS {
+namespace HiviewDFX {
+enum class HiCheckerParam : uint32_t {
+    JSLEAK_CHECK = 0,
+    JSLEAK_DUMP,
+    JSLEAK_DUMP_QUOTA,
+    RAWHEAP_SIDECAR,
+    RAWHEAP_COMPRESS,
+    RAWHEAP_DELTA,
+    LEAKLIST_BINARY,
+    JSLEAK_INIT_DEFERRED,
+    PARAM_COUNT
+};
+
+/*
+ * Process wide cache of the hichecker system parameters. Each parameter keeps one CachedHandle for the life
+ * of the process and its value is copied and parsed again only when the parameter system reports a change,
+ * so a read is a serial compare on the hot paths of the leak watcher. Reads are safe from any thread.
+ */
+class HiCheckerParamCache {
+public:
+    HiCheckerParamCache() = delete;
+    HiCheckerParamCache(const HiCheckerParamCache&) = delete;
+    HiCheckerParamCache& operator = (HiCheckerParamCache&) = delete;
+
+    static const char* GetName(HiCheckerParam param);
+    static std::string GetString(HiCheckerParam param);
+    /* "true" and "false" are parsed, anything else gives the default of the parameter */
+    static bool GetBool(HiCheckerParam param);
+    static uint64_t GetUint64(HiCheckerParam param);
+    /* the value is exactly prefix followed by suffix, compared without building the string */
+    static bool Equals(HiCheckerParam param, std::string_view prefix, std::string_view suffix);
+};
+} // HiviewDFX
+} // OHOS
+#endif // HIVIEWDFX_HICHECKER_PARAM_CACHE_H
@@ -27,6 +27,7 @@ bool GetjsLeakWatcherEnableStatus();
 
 #ifdef JSLEAKWATHCER_UNITTEST
 bool TestCheckJsLeakWatcherParam(const char* bundleName);
+uint32_t TestGetDeferredInitCount();
 #endif
 
 #endif //HIVIEWDFX_HICHECKER_JS_LEAK_WATCHER_TS_H
\ No newline at end of file
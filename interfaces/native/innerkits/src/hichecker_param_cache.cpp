@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hichecker_param_cache.h"
+
+#include <cstdlib>
+#include <mutex>
+
+#include "sys_param.h"
+
+namespace OHOS {
+namespace HiviewDFX {
+namespace {
+constexpr int DECIMAL_BASE = 10;
+constexpr uint32_t PARAM_COUNT = static_cast<uint32_t>(HiCheckerParam::PARAM_COUNT);
+
+struct ParamDesc {
+    const char* name;
+    const char* defValue;
+    bool defBool;
+};
+
+constexpr ParamDesc PARAM_DESCS[PARAM_COUNT] = {
+    { "hiviewdfx.hichecker.jsleakwatcher.leak.check", "", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.dump", "true", true },
+    { "hiviewdfx.hichecker.jsleakwatcher.dump.quota", "0", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.rawheap.sidecar", "false", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.rawheap.compress", "false", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.rawheap.delta", "false", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.leaklist.binary", "false", false },
+    { "hiviewdfx.hichecker.jsleakwatcher.init.deferred", "false", false },
+};
+
+class CachedParam {
+public:
+    CachedParam() = default;
+    CachedParam(const CachedParam&) = delete;
+    CachedParam& operator = (const CachedParam&) = delete;
+
+    void Init(const ParamDesc* desc)
+    {
+        desc_ = desc;
+        value_ = desc->defValue;
+        Parse();
+    }
+
+    std::string GetString()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        Refresh();
+        return value_;
+    }
+
+    bool GetBool()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        Refresh();
+        return boolValue_;
+    }
+
+    uint64_t GetUint64()
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        Refresh();
+        return uintValue_;
+    }
+
+    bool Equals(std::string_view prefix, std::string_view suffix)
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        Refresh();
+        std::string_view value = value_;
+        return value.size() == prefix.size() + suffix.size() && value.substr(0, prefix.size()) == prefix &&
+            value.substr(prefix.size()) == suffix;
+    }
+
+private:
+    void Refresh()
+    {
+        if (handle_ == nullptr) {
+            handle_ = CachedParameterCreate(desc_->name, desc_->defValue);
+            if (handle_ == nullptr) {
+                return;
+            }
+        }
+        int changed = 0;
+        const char* value = CachedParameterGetChanged(handle_, &changed);
+        if (value == nullptr || (changed == 0 && fetched_)) {
+            return;
+        }
+        fetched_ = true;
+        value_ = value;
+        Parse();
+    }
+
+    void Parse()
+    {
+        if (value_ == "true") {
+            boolValue_ = true;
+        } else if (value_ == "false") {
+            boolValue_ = false;
+        } else {
+            boolValue_ = desc_->defBool;
+        }
+        uintValue_ = strtoull(value_.c_str(), nullptr, DECIMAL_BASE);
+    }
+
+    const ParamDesc* desc_ = nullptr;
+    std::mutex lock_;
+    CachedHandle handle_ = nullptr;
+    bool fetched_ = false;
+    std::string value_;
+    bool boolValue_ = false;
+    uint64_t uintValue_ = 0;
+};
+
+CachedParam& GetParam(HiCheckerParam param)
+{
+    // never destroyed, the handles stay valid for threads still reading at process exit
+    static CachedParam* params = [] {
+        auto* created = new CachedParam[PARAM_COUNT];
+        for (uint32_t i = 0; i < PARAM_COUNT; i++) {
+            created[i].Init(&PARAM_DESCS[i]);
+        }
+        return created;
+    }();
+    return params[static_cast<uint32_t>(param)];
+}
+}
+
+const char* HiCheckerParamCache::GetName(HiCheckerParam param)
+{
+    return PARAM_DESCS[static_cast<uint32_t>(param)].name;
+}
+
+std::string HiCheckerParamCache::GetString(HiCheckerParam param)
+{
+    return GetParam(param).GetString();
+}
+
+bool HiCheckerParamCache::GetBool(HiCheckerParam param)
+{
+    return GetParam(param).GetBool();
+}
+
+uint64_t HiCheckerParamCache::GetUint64(HiCheckerParam param)
+{
+    return GetParam(param).GetUint64();
+}
+
+bool HiCheckerParamCache::Equals(HiCheckerParam param, std::string_view prefix, std::string_view suffix)
+{
+    return GetParam(param).Equals(prefix, suffix);
+}
+} // HiviewDFX
+} // OHOS
@@ -14,12 +14,15 @@
  */
 
 #include <cstring>
+#include <memory>
 
+#include "event_handler.h"
+#include "event_runner.h"
+#include "hichecker_param_cache.h"
 #include "hilog/log.h"
 #include "js_leak_watcher_ts.h"
 #include "hitrace_meter.h"
 #include "securec.h"
-#include "sys_param.h"
 #include "parameters.h"
 
 #undef LOG_DOMAIN
@@ -28,9 +31,14 @@
 #undef LOG_TAG
 #define LOG_TAG "JSLEAK_WATCHER_TS"
 
-#define JSLEAK_WATCHER_NAME_LEN 256
-
 static bool g_enableStatus = false;
+static uint32_t g_deferredInitCount = 0;
+
+/* the cleanup hook and the idle task both run on the JS thread of env */
+struct DeferredInit {
+    napi_env env;
+    std::string bundleName;
+};
 
 bool IsDebuggableHap()
 {
@@ -48,22 +56,8 @@ bool CheckJsLeakWatcherParam(const char* bundleName)
     if (!bundleName) {
         return false;
     }
-    char paraName[JSLEAK_WATCHER_NAME_LEN] = "hiviewdfx.hichecker.jsleakwatcher.leak.check";
-    const std::string disable = "disable." + std::string(bundleName);
-    CachedHandle appEnableHandle = CachedParameterCreate(paraName, disable.c_str());
-    if (appEnableHandle == nullptr) {
-        return false;
-    }
-    const char *paramValue = CachedParameterGet(appEnableHandle);
-    if (paramValue != nullptr) {
-        const std::string enable = "enable." + std::string(bundleName);
-        if (strcmp(paramValue, enable.c_str()) == 0) {
-            CachedParameterDestroy(appEnableHandle);
-            return true;
-        }
-    }
-    CachedParameterDestroy(appEnableHandle);
-    return false;
+    return OHOS::HiviewDFX::HiCheckerParamCache::Equals(OHOS::HiviewDFX::HiCheckerParam::JSLEAK_CHECK, "enable.",
+        bundleName);
 }
 
 void SetjsLeakWatcherEnableStatus(bool checkStatus)
@@ -106,19 +100,8 @@ void CreateCallbackObject(napi_env env, napi_value* js_callback)
     }
 }
 
-void JSLeakWatcherEarlyInit(napi_env env, std::string bundleName)
+static void LoadJsLeakWatcher(napi_env env, const std::string& bundleName)
 {
-    HITRACE_METER_NAME(HITRACE_TAG_APP, __PRETTY_FUNCTION__);
-    if (!IsRootVersion() && !IsDebuggableHap()) {
-        HILOG_ERROR(LOG_CORE, "user mode release hap is not allow");
-        return;
-    }
-    bool ret = CheckJsLeakWatcherParam(bundleName.c_str());
-    SetjsLeakWatcherEnableStatus(ret);
-    if (!ret) {
-        return;
-    }
-
     napi_handle_scope scope;
     napi_open_handle_scope(env, &scope);
     HILOG_INFO(LOG_CORE, "JSLeakWatcherEarlyInit %{public}s", bundleName.c_str());
@@ -147,10 +130,87 @@ void JSLeakWatcherEarlyInit(napi_env env, std::string bundleName)
     napi_close_handle_scope(env, scope);
 }
 
+static void OnDeferredInitEnvCleanup(void* data)
+{
+    static_cast<DeferredInit*>(data)->env = nullptr;
+}
+
+static void RunDeferredInit(DeferredInit* deferred)
+{
+    // this span is the startup time the deferred mode keeps off the critical path
+    HITRACE_METER_NAME(HITRACE_TAG_APP, "JSLeakWatcherDeferredInit");
+    napi_env env = deferred->env;
+    if (env == nullptr) {
+        HILOG_INFO(LOG_CORE, "env released before the deferred init");
+        delete deferred;
+        return;
+    }
+    napi_remove_env_cleanup_hook(env, OnDeferredInitEnvCleanup, deferred);
+    g_deferredInitCount++;
+    LoadJsLeakWatcher(env, deferred->bundleName);
+    delete deferred;
+}
+
+/* the handler outlives every posted init task, the main runner is fixed for the process */
+static std::shared_ptr<OHOS::AppExecFwk::EventHandler> GetDeferredInitHandler()
+{
+    static std::shared_ptr<OHOS::AppExecFwk::EventHandler> handler = [] {
+        auto runner = OHOS::AppExecFwk::EventRunner::GetMainEventRunner();
+        return runner == nullptr ? nullptr : std::make_shared<OHOS::AppExecFwk::EventHandler>(runner);
+    }();
+    return handler;
+}
+
+/* records the intent and loads the module on the first idle slot of the main runner, false when not posted */
+static bool PostDeferredInit(napi_env env, const std::string& bundleName)
+{
+    auto handler = GetDeferredInitHandler();
+    if (handler == nullptr) {
+        return false;
+    }
+    auto* deferred = new DeferredInit { env, bundleName };
+    if (napi_add_env_cleanup_hook(env, OnDeferredInitEnvCleanup, deferred) != napi_ok) {
+        delete deferred;
+        return false;
+    }
+    if (!handler->PostTask([deferred] { RunDeferredInit(deferred); }, "JSLeakWatcherDeferredInit", 0,
+        OHOS::AppExecFwk::EventHandler::Priority::IDLE)) {
+        napi_remove_env_cleanup_hook(env, OnDeferredInitEnvCleanup, deferred);
+        delete deferred;
+        return false;
+    }
+    return true;
+}
+
+void JSLeakWatcherEarlyInit(napi_env env, std::string bundleName)
+{
+    HITRACE_METER_NAME(HITRACE_TAG_APP, __PRETTY_FUNCTION__);
+    if (!IsRootVersion() && !IsDebuggableHap()) {
+        HILOG_ERROR(LOG_CORE, "user mode release hap is not allow");
+        return;
+    }
+    bool ret = CheckJsLeakWatcherParam(bundleName.c_str());
+    SetjsLeakWatcherEnableStatus(ret);
+    if (!ret) {
+        return;
+    }
+    if (OHOS::HiviewDFX::HiCheckerParamCache::GetBool(OHOS::HiviewDFX::HiCheckerParam::JSLEAK_INIT_DEFERRED) &&
+        PostDeferredInit(env, bundleName)) {
+        HILOG_INFO(LOG_CORE, "JSLeakWatcherEarlyInit deferred to idle");
+        return;
+    }
+    LoadJsLeakWatcher(env, bundleName);
+}
+
 //for test
 #ifdef JSLEAKWATHCER_UNITTEST
 bool TestCheckJsLeakWatcherParam(const char* bundleName)
 {
     return CheckJsLeakWatcherParam(bundleName);
 }
+
+uint32_t TestGetDeferredInitCount()
+{
+    return g_deferredInitCount;
+}
 #endif
\ No newline at end of file
@@ -13,6 +13,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <fstream>
@@ -20,6 +21,8 @@
 #include <gtest/gtest.h>
 #include <string>
 
+#include "ability_connection_registry.h"
+#include "arkui_perf_checker.h"
 #include "caution.h"
 #include "hichecker.h"
 #include "hichecker_wrapper.h"
@@ -35,6 +38,12 @@ namespace {
     const uint64_t RULE_ERROR1 = -1;
     const uint64_t RULE_ERROR2 = 999999999;
     const uint64_t BASELINE_SIZE = 164 * 1024;
+    const int64_t MAX_REPORT_FRAME_DURATION_NS = 100;
+    const uint32_t OVER_BUDGET_COST_US = 20000;
+    const uint32_t UNDER_BUDGET_COST_US = 1000;
+    const uint64_t CONNECTION_OWNER_ID = 1001;
+    const uint64_t LEAK_THRESHOLD_MS = 1000;
+    const uint32_t CONNECTION_COUNT = 100000;
 
     vector<string> OUTPUT_PATH = {
         "/system/etc/param/hichecker.para",
@@ -487,5 +496,228 @@ HWTEST_F(HiCheckerNativeTest, MultiThreadNotifyNetWorkUsageTest001, TestSize.Lev
     
     HiChecker::RemoveRule(Rule::RULE_THREAD_CHECK_NETWORK_USAGE);
 }
+
+/**
+  * @tc.name: ArkUIPerfCheckerTest001
+  * @tc.desc: test caution is raised when a phase exceeds its budget for K of the last N frames
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, ArkUIPerfCheckerTest001, TestSize.Level1)
+{
+    auto& checker = ArkUIPerfChecker::GetInstance();
+    checker.Reset();
+    ASSERT_TRUE(checker.SetViolationWindow(3, 10));
+    HiChecker::AddRule(Rule::RULE_CHECK_ARKUI_PERFORMANCE);
+    ArkUIFrameTiming timing;
+    for (uint64_t frame = 0; frame < 10; frame++) {
+        timing.frameId = frame;
+        timing.phaseCostUs[ARKUI_PHASE_BUILD] = (frame % 4 == 0) ? OVER_BUDGET_COST_US : UNDER_BUDGET_COST_US;
+        ASSERT_TRUE(checker.ReportFrame(timing));
+    }
+    ASSERT_EQ(checker.ProcessPendingFrames(), 10);
+    EXPECT_EQ(checker.GetCautionCount(), 1);
+    HiChecker::RemoveRule(Rule::RULE_CHECK_ARKUI_PERFORMANCE);
+    checker.Reset();
+}
+
+/**
+  * @tc.name: ArkUIPerfCheckerTest002
+  * @tc.desc: test no caution is raised when the rule is disabled or violations stay below K
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, ArkUIPerfCheckerTest002, TestSize.Level1)
+{
+    auto& checker = ArkUIPerfChecker::GetInstance();
+    checker.Reset();
+    ASSERT_TRUE(checker.SetViolationWindow(3, 10));
+    ASSERT_FALSE(checker.SetViolationWindow(11, 10));
+    ASSERT_FALSE(checker.SetViolationWindow(1, ArkUIPerfChecker::MAX_WINDOW_SIZE + 1));
+    ArkUIFrameTiming timing;
+    timing.phaseCostUs[ARKUI_PHASE_LAYOUT] = OVER_BUDGET_COST_US;
+    for (int i = 0; i < 10; i++) {
+        checker.ReportFrame(timing);
+    }
+    checker.ProcessPendingFrames();
+    EXPECT_EQ(checker.GetCautionCount(), 0);
+
+    HiChecker::AddRule(Rule::RULE_CHECK_ARKUI_PERFORMANCE);
+    ASSERT_TRUE(checker.SetViolationWindow(3, 10));
+    for (int i = 0; i < 20; i++) {
+        timing.phaseCostUs[ARKUI_PHASE_LAYOUT] = (i % 5 == 0) ? OVER_BUDGET_COST_US : UNDER_BUDGET_COST_US;
+        checker.ReportFrame(timing);
+    }
+    checker.ProcessPendingFrames();
+    EXPECT_EQ(checker.GetCautionCount(), 0);
+    HiChecker::RemoveRule(Rule::RULE_CHECK_ARKUI_PERFORMANCE);
+    checker.Reset();
+}
+
+/**
+  * @tc.name: ArkUIPerfCheckerTest003
+  * @tc.desc: test rolling percentiles and dropped frames when the queue is full
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, ArkUIPerfCheckerTest003, TestSize.Level1)
+{
+    auto& checker = ArkUIPerfChecker::GetInstance();
+    checker.Reset();
+    ASSERT_TRUE(checker.SetViolationWindow(100, 100));
+    ArkUIFrameTiming timing;
+    for (uint32_t cost = 1; cost <= 100; cost++) {
+        timing.phaseCostUs[ARKUI_PHASE_RENDER] = cost;
+        checker.ReportFrame(timing);
+    }
+    checker.ProcessPendingFrames();
+    EXPECT_EQ(checker.GetPhasePercentile(ARKUI_PHASE_RENDER, 50), 50);
+    EXPECT_EQ(checker.GetPhasePercentile(ARKUI_PHASE_RENDER, 100), 100);
+    EXPECT_EQ(checker.GetPhasePercentile(ARKUI_PHASE_BUILD, 99), 0);
+
+    for (uint32_t i = 0; i < ArkUIPerfChecker::QUEUE_CAPACITY + 1; i++) {
+        checker.ReportFrame(timing);
+    }
+    EXPECT_EQ(checker.GetDroppedFrameCount(), 1);
+    checker.Reset();
+}
+
+/**
+  * @tc.name: ArkUIPerfCheckerPerfTest001
+  * @tc.desc: test performance for ReportFrame
+  * @tc.type: PERF
+*/
+HWTEST_F(HiCheckerNativeTest, ArkUIPerfCheckerPerfTest001, TestSize.Level2)
+{
+    auto& checker = ArkUIPerfChecker::GetInstance();
+    checker.Reset();
+    ArkUIFrameTiming timing;
+    const int batchSize = static_cast<int>(ArkUIPerfChecker::QUEUE_CAPACITY / 2);
+    int64_t total = 0;
+    // the clock is read once per batch, reading it around every call would cost more than ReportFrame
+    for (int i = 0; i < LOOP_COUNT; i += batchSize) {
+        checker.ProcessPendingFrames();
+        int end = std::min(i + batchSize, LOOP_COUNT);
+        int64_t start = GetTimeNs();
+        for (int j = i; j < end; j++) {
+            timing.frameId = static_cast<uint64_t>(j);
+            checker.ReportFrame(timing);
+        }
+        total += GetTimeNs() - start;
+    }
+    ASSERT_LT(total / LOOP_COUNT, MAX_REPORT_FRAME_DURATION_NS);
+    checker.Reset();
+}
+
+/**
+  * @tc.name: AbilityConnectionRegistryTest001
+  * @tc.desc: test connect and disconnect by handle, stale handles are rejected
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, AbilityConnectionRegistryTest001, TestSize.Level1)
+{
+    auto& registry = AbilityConnectionRegistry::GetInstance();
+    registry.Reset();
+    ConnectionHandle first = registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    ConnectionHandle second = registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    ASSERT_NE(first, INVALID_CONNECTION_HANDLE);
+    ASSERT_NE(first, second);
+    EXPECT_EQ(registry.GetOwnerConnectionCount(CONNECTION_OWNER_ID), 2);
+    EXPECT_TRUE(registry.Disconnect(first));
+    EXPECT_FALSE(registry.Disconnect(first));
+    ConnectionHandle reused = registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.other");
+    EXPECT_NE(reused, first);
+    EXPECT_FALSE(registry.Disconnect(first));
+    EXPECT_FALSE(registry.Disconnect(INVALID_CONNECTION_HANDLE));
+    EXPECT_EQ(registry.DisconnectOwner(CONNECTION_OWNER_ID), 2);
+    EXPECT_EQ(registry.GetConnectionCount(), 0);
+    registry.Reset();
+}
+
+/**
+  * @tc.name: AbilityConnectionRegistryTest002
+  * @tc.desc: test incremental age scan reports each leaked connection once
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, AbilityConnectionRegistryTest002, TestSize.Level1)
+{
+    auto& registry = AbilityConnectionRegistry::GetInstance();
+    registry.Reset();
+    registry.SetLeakThreshold(LEAK_THRESHOLD_MS);
+    HiChecker::AddRule(Rule::RULE_CHECK_ABILITY_CONNECTION_LEAK);
+    registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.old", 0);
+    registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.old", 0);
+    registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.new", LEAK_THRESHOLD_MS);
+    EXPECT_EQ(registry.ScanStep(LEAK_THRESHOLD_MS, 1), 1);
+    EXPECT_EQ(registry.ScanStep(LEAK_THRESHOLD_MS, 2), 1);
+    EXPECT_EQ(registry.ScanStep(LEAK_THRESHOLD_MS, 3), 0);
+    EXPECT_EQ(registry.ScanStep(LEAK_THRESHOLD_MS * 2, 3), 1);
+    HiChecker::RemoveRule(Rule::RULE_CHECK_ABILITY_CONNECTION_LEAK);
+    registry.Reset();
+}
+
+/**
+  * @tc.name: AbilityConnectionRegistryTest003
+  * @tc.desc: test released slots are recycled so the table does not grow
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, AbilityConnectionRegistryTest003, TestSize.Level1)
+{
+    auto& registry = AbilityConnectionRegistry::GetInstance();
+    registry.Reset();
+    std::vector<ConnectionHandle> handles;
+    for (uint32_t round = 0; round < 2; round++) {
+        for (uint32_t i = 0; i < CONNECTION_COUNT; i++) {
+            handles.push_back(registry.Connect(i % 100, "owner", "com.test.service"));
+        }
+        for (auto handle : handles) {
+            ASSERT_LE(handle & 0xFFFFFFFFULL, CONNECTION_COUNT);
+            ASSERT_TRUE(registry.Disconnect(handle));
+        }
+        handles.clear();
+        ASSERT_EQ(registry.GetConnectionCount(), 0);
+    }
+    EXPECT_TRUE(registry.StartAgeScan(10, 100));
+    EXPECT_FALSE(registry.StartAgeScan(10, 100));
+    registry.StopAgeScan();
+    registry.Reset();
+}
+
+/**
+  * @tc.name: AbilityConnectionRegistryTest004
+  * @tc.desc: test owners and targets are released with their last connection and reset handles stay invalid
+  * @tc.type: FUNC
+*/
+HWTEST_F(HiCheckerNativeTest, AbilityConnectionRegistryTest004, TestSize.Level1)
+{
+    auto& registry = AbilityConnectionRegistry::GetInstance();
+    registry.Reset();
+    for (uint32_t i = 0; i < CONNECTION_COUNT; i++) {
+        ConnectionHandle handle = registry.Connect(i, "owner" + std::to_string(i), "target" + std::to_string(i));
+        ASSERT_EQ(registry.GetOwnerCount(), 1);
+        ASSERT_EQ(registry.GetTargetCount(), 1);
+        ASSERT_TRUE(registry.Disconnect(handle));
+        ASSERT_EQ(registry.GetOwnerCount(), 0);
+        ASSERT_EQ(registry.GetTargetCount(), 0);
+    }
+    registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    EXPECT_EQ(registry.DisconnectOwner(CONNECTION_OWNER_ID), 2);
+    EXPECT_EQ(registry.GetOwnerCount(), 0);
+    EXPECT_EQ(registry.GetTargetCount(), 0);
+
+    ConnectionHandle stale = registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    registry.Reset();
+    ConnectionHandle fresh = registry.Connect(CONNECTION_OWNER_ID, "owner", "com.test.service");
+    EXPECT_NE(stale, fresh);
+    EXPECT_FALSE(registry.Disconnect(stale));
+    EXPECT_TRUE(registry.Disconnect(fresh));
+
+    for (int i = 0; i < LOOP_COUNT; i++) {
+        EXPECT_TRUE(registry.StartAgeScan(10, 100));
+        std::thread stopper([&registry] { registry.StopAgeScan(); });
+        registry.StartAgeScan(10, 100);
+        stopper.join();
+        registry.StopAgeScan();
+    }
+    registry.Reset();
+}
 } // namespace HiviewDFX
 } // namespace OHOS
@@ -14,6 +14,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <fcntl.h>
 #include <fstream>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -23,11 +24,24 @@
 #include <string>
 #include <vector>
 #include <climits>
+#include <chrono>
 
 #include "event_handler.h"
 #include "event_runner.h"
+#include "js_leak_watcher_delta.h"
+#include "js_leak_watcher_dump_pool.h"
+#include "js_leak_watcher_filter.h"
+#include "js_leak_watcher_leaklist.h"
 #include "js_leak_watcher_napi.h"
+#include "js_leak_watcher_rawheap.h"
+#include "js_leak_watcher_registry.h"
+#include "js_leak_watcher_report.h"
+#include "js_leak_watcher_retention.h"
+#include "js_leak_watcher_scheduler.h"
 #include "js_leak_watcher_ts.h"
+#include "native_engine/impl/ark/ark_native_engine.h"
+#include "securec.h"
+#include "zlib.h"
 
 using namespace testing::ext;
 using namespace OHOS::AppExecFwk;
@@ -36,6 +50,16 @@ namespace {
     const std::string TEST_FILE_PATH = "/data/test_js_leak_watcher.txt";
     const std::string TEST_META_FILE_PATH = "/data/test_metadata.json";
     const std::string INVALID_FILE_PATH = "/invalid/path/test.txt";
+    const std::string TEST_DUMP_DIR = "/data/test_jsleak_retention";
+    constexpr uint32_t LEAK_DIFF_SCALES[] = { 1000, 10000, 100000 };
+    constexpr int64_t MAX_LEAK_DIFF_COST_MS = 100;
+
+    napi_value TestObjectConstructor(napi_env env, napi_callback_info info)
+    {
+        napi_value thisVar = nullptr;
+        napi_get_cb_info(env, info, nullptr, nullptr, &thisVar, nullptr);
+        return thisVar;
+    }
 }
 
 namespace OHOS {
@@ -870,5 +894,1039 @@ HWTEST_F(JsLeakWatcherNapiTest, FileOperationsChainTest003, TestSize.Level1)
         ASSERT_GT(afterMetaSize, beforeMetaSize);
     }
 }
+
+/**
+ * @tc.name: LeakObjectRegistryTest001
+ * @tc.desc: test add, remove and lookup of watched objects with interned names
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakObjectRegistryTest001, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    ASSERT_TRUE(registry.Add(1, "CustomComponent", "msg"));
+    ASSERT_FALSE(registry.Add(1, "CustomComponent", "msg"));
+    ASSERT_TRUE(registry.Add(2, "CustomComponent", ""));
+    ASSERT_EQ(registry.Size(), 2);
+    ASSERT_TRUE(registry.Contains(2));
+    ASSERT_TRUE(registry.Remove(1));
+    ASSERT_FALSE(registry.Remove(1));
+    ASSERT_FALSE(registry.Contains(1));
+    ASSERT_EQ(registry.Size(), 1);
+    registry.Clear();
+    ASSERT_EQ(registry.Size(), 0);
+    ASSERT_FALSE(registry.Contains(2));
+}
+
+/**
+ * @tc.name: LeakObjectRegistryTest002
+ * @tc.desc: test incremental iteration returns every live entry once across growth and removals
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakObjectRegistryTest002, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    const uint32_t objectCount = 10000;
+    for (uint32_t hash = 1; hash <= objectCount; hash++) {
+        ASSERT_TRUE(registry.Add(hash, "Object" + std::to_string(hash % 10), "msg"));
+    }
+    for (uint32_t hash = 1; hash <= objectCount; hash += 2) {
+        ASSERT_TRUE(registry.Remove(hash));
+    }
+    std::vector<LeakObjectInfo> leakList;
+    registry.ResetCursor();
+    while (registry.NextBatch(LEAK_LIST_BATCH_SIZE, leakList)) {}
+    ASSERT_EQ(leakList.size(), objectCount / 2);
+    for (const auto& leakInfo : leakList) {
+        ASSERT_EQ(leakInfo.hash % 2, 0);
+        ASSERT_EQ(registry.GetString(leakInfo.nameId), "Object" + std::to_string(leakInfo.hash % 10));
+        ASSERT_EQ(registry.GetString(leakInfo.msgId), "msg");
+    }
+}
+
+/**
+ * @tc.name: LeakObjectRegistryTest003
+ * @tc.desc: test iteration stops when the table is rehashed underneath it
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakObjectRegistryTest003, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    registry.Add(1, "Object", "msg");
+    registry.ResetCursor();
+    for (uint32_t hash = 2; hash < 1000; hash++) {
+        registry.Add(hash, "Object", "msg");
+    }
+    std::vector<LeakObjectInfo> leakList;
+    ASSERT_FALSE(registry.NextBatch(LEAK_LIST_BATCH_SIZE, leakList));
+    ASSERT_TRUE(leakList.empty());
+}
+
+/**
+ * @tc.name: LeakListDiffTest001
+ * @tc.desc: test added, removed and persistent hashes of a diff, duplicates reported once
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListDiffTest001, TestSize.Level1)
+{
+    std::vector<uint32_t> before = { 1, 2, 3, 3, 4 };
+    std::vector<uint32_t> after = { 3, 4, 5, 5, 6 };
+    LeakListDiff diff;
+    DiffLeakHashes(before, after, diff);
+    ASSERT_EQ(diff.added, std::vector<uint32_t>({ 5, 6 }));
+    ASSERT_EQ(diff.removed, std::vector<uint32_t>({ 1, 2 }));
+    ASSERT_EQ(diff.persistent, std::vector<uint32_t>({ 3, 4 }));
+    DiffLeakHashes({}, {}, diff);
+    ASSERT_TRUE(diff.added.empty());
+    ASSERT_TRUE(diff.removed.empty());
+    ASSERT_TRUE(diff.persistent.empty());
+}
+
+/**
+ * @tc.name: LeakListDiffTest002
+ * @tc.desc: test hash set comparison ignores order
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListDiffTest002, TestSize.Level1)
+{
+    ASSERT_TRUE(IsSameLeakHashSet({}, {}));
+    ASSERT_TRUE(IsSameLeakHashSet({ 1, 2, 3 }, { 3, 1, 2 }));
+    ASSERT_FALSE(IsSameLeakHashSet({ 1, 2, 3 }, { 1, 2 }));
+    ASSERT_FALSE(IsSameLeakHashSet({ 1, 2 }, { 1, 2, 4 }));
+    ASSERT_FALSE(IsSameLeakHashSet({ 1, 2, 3 }, { 1, 2, 4 }));
+}
+
+/**
+ * @tc.name: LeakListDiffPerfTest001
+ * @tc.desc: test diff of half overlapping leak lists at 1k, 10k and 100k objects
+ * @tc.type: PERF
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListDiffPerfTest001, TestSize.Level2)
+{
+    for (uint32_t scale : LEAK_DIFF_SCALES) {
+        LeakObjectRegistry registry;
+        std::vector<uint32_t> snapshot;
+        for (uint32_t hash = 1; hash <= scale; hash++) {
+            registry.Add(hash, "CustomComponent", "");
+        }
+        registry.CollectHashes(snapshot);
+        for (uint32_t hash = 1; hash <= scale / 2; hash++) {
+            registry.Remove(hash);
+            registry.Add(hash + scale, "CustomComponent", "");
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<uint32_t> liveHashes;
+        registry.CollectHashes(liveHashes);
+        LeakListDiff diff;
+        DiffLeakHashes(snapshot, liveHashes, diff);
+        int64_t costMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        ASSERT_EQ(diff.added.size(), scale / 2);
+        ASSERT_EQ(diff.removed.size(), scale / 2);
+        ASSERT_EQ(diff.persistent.size(), scale - scale / 2);
+        ASSERT_LT(costMs, MAX_LEAK_DIFF_COST_MS);
+    }
+}
+
+/**
+ * @tc.name: LeakWatcherFilterTest001
+ * @tc.desc: test exclusion list matches names case-insensitively
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakWatcherFilterTest001, TestSize.Level1)
+{
+    LeakWatcherFilter filter;
+    ASSERT_FALSE(filter.IsNameExcluded("MyComponent"));
+    filter.SetExclusionList({ "MyComponent", "mainWindow" });
+    ASSERT_TRUE(filter.IsNameExcluded("mycomponent"));
+    ASSERT_TRUE(filter.IsNameExcluded("MYCOMPONENT"));
+    ASSERT_TRUE(filter.IsNameExcluded("MainWindow"));
+    ASSERT_FALSE(filter.IsNameExcluded("MyComponent2"));
+    ASSERT_FALSE(filter.IsNameExcluded(""));
+    filter.SetExclusionList({});
+    ASSERT_FALSE(filter.IsNameExcluded("MyComponent"));
+}
+
+/**
+ * @tc.name: LeakWatcherFilterTest002
+ * @tc.desc: test monitored object IDs take precedence over the exclusion list
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakWatcherFilterTest002, TestSize.Level1)
+{
+    LeakWatcherFilter filter;
+    ASSERT_FALSE(filter.IsObjectFiltered("MyComponent", false, 0));
+    filter.SetExclusionList({ "MyComponent" });
+    ASSERT_TRUE(filter.IsObjectFiltered("mycomponent", true, 1));
+    ASSERT_FALSE(filter.IsObjectFiltered("OtherComponent", false, 0));
+    filter.SetObjectIds({ 1, 2 });
+    ASSERT_FALSE(filter.IsObjectFiltered("MyComponent", true, 1));
+    ASSERT_FALSE(filter.IsObjectFiltered("OtherComponent", true, 2));
+    ASSERT_TRUE(filter.IsObjectFiltered("OtherComponent", true, 3));
+    ASSERT_TRUE(filter.IsObjectFiltered("OtherComponent", false, 0));
+    filter.Clear();
+    ASSERT_FALSE(filter.IsObjectFiltered("MyComponent", true, 1));
+}
+
+static std::string ReadFileContent(const std::string& filePath)
+{
+    std::ifstream file(filePath, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @tc.name: RawHeapMetaDataTest001
+ * @tc.desc: test metadata and footer layout appended to a rawheap file
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapMetaDataTest001, TestSize.Level1)
+{
+    const std::string rawHeap = "test heap dump content";
+    const std::string metaData(5000, 'm');
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << rawHeap;
+    std::ofstream(TEST_META_FILE_PATH, std::ios::binary) << metaData;
+    RawHeapMetaData rawHeapMetaData(TEST_META_FILE_PATH);
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH));
+    std::string content = ReadFileContent(TEST_FILE_PATH);
+    ASSERT_EQ(content.size(), rawHeap.size() + metaData.size() + sizeof(uint32_t) * 2);
+    ASSERT_EQ(content.substr(0, rawHeap.size()), rawHeap);
+    ASSERT_EQ(content.substr(rawHeap.size(), metaData.size()), metaData);
+    uint32_t footer[2] = {0};
+    memcpy(footer, content.data() + rawHeap.size() + metaData.size(), sizeof(footer));
+    ASSERT_EQ(footer[0], rawHeap.size());
+    ASSERT_EQ(footer[1], metaData.size());
+}
+
+/**
+ * @tc.name: RawHeapMetaDataTest002
+ * @tc.desc: test rawheap file is left untouched when the metadata file is missing
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapMetaDataTest002, TestSize.Level1)
+{
+    const std::string rawHeap = "test heap dump content";
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << rawHeap;
+    RawHeapMetaData rawHeapMetaData(TEST_META_FILE_PATH);
+    ASSERT_FALSE(rawHeapMetaData.Append(TEST_FILE_PATH));
+    ASSERT_EQ(ReadFileContent(TEST_FILE_PATH), rawHeap);
+    RawHeapMetaData invalidTarget(TEST_META_FILE_PATH);
+    std::ofstream(TEST_META_FILE_PATH, std::ios::binary) << "{}";
+    ASSERT_FALSE(invalidTarget.Append(INVALID_FILE_PATH));
+}
+
+/**
+ * @tc.name: RawHeapMetaDataTest003
+ * @tc.desc: test the metadata file is opened once and reused by later dumps
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapMetaDataTest003, TestSize.Level1)
+{
+    const std::string metaData = "{\"test\": \"metadata\"}";
+    std::ofstream(TEST_META_FILE_PATH, std::ios::binary) << metaData;
+    RawHeapMetaData rawHeapMetaData(TEST_META_FILE_PATH);
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << "first";
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH));
+    unlink(TEST_META_FILE_PATH.c_str());
+    std::ofstream(TEST_FILE_PATH, std::ios::binary | std::ios::trunc) << "second";
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH));
+    std::string content = ReadFileContent(TEST_FILE_PATH);
+    ASSERT_EQ(content.substr(std::string("second").size(), metaData.size()), metaData);
+}
+
+/**
+ * @tc.name: RawHeapMetaDataTest004
+ * @tc.desc: test sidecar mode writes one shared metadata file and a reference footer
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapMetaDataTest004, TestSize.Level1)
+{
+    const std::string rawHeap = "test heap dump content";
+    const std::string metaData = "{\"test\": \"metadata\"}";
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << rawHeap;
+    std::ofstream(TEST_META_FILE_PATH, std::ios::binary) << metaData;
+    RawHeapMetaData rawHeapMetaData(TEST_META_FILE_PATH);
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH, META_DATA_SIDECAR));
+    std::string sidecarPath = rawHeapMetaData.GetSidecarPath(TEST_FILE_PATH);
+    ASSERT_EQ(ReadFileContent(sidecarPath), metaData);
+    std::string content = ReadFileContent(TEST_FILE_PATH);
+    ASSERT_EQ(content.size(), rawHeap.size() + sizeof(RawHeapMetaDataRef) + sizeof(uint32_t) * 2);
+    RawHeapMetaDataRef ref;
+    memcpy(&ref, content.data() + rawHeap.size(), sizeof(ref));
+    ASSERT_EQ(ref.magic, META_DATA_REF_MAGIC);
+    ASSERT_EQ(ref.version, META_DATA_REF_VERSION);
+    ASSERT_EQ(ref.metaDataSize, metaData.size());
+    uint32_t footer[2] = {0};
+    memcpy(footer, content.data() + rawHeap.size() + sizeof(ref), sizeof(footer));
+    ASSERT_EQ(footer[0], rawHeap.size());
+    ASSERT_EQ(footer[1], sizeof(RawHeapMetaDataRef));
+    unlink(sidecarPath.c_str());
+}
+
+/**
+ * @tc.name: CompressRawHeapTest001
+ * @tc.desc: test compressed blocks, index and trailer can restore the original dump
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, CompressRawHeapTest001, TestSize.Level1)
+{
+    const uint32_t blockSize = 4096;
+    std::string rawHeap;
+    for (uint32_t i = 0; rawHeap.size() < blockSize * 3 + 100; i++) {
+        rawHeap += "object" + std::to_string(i % 97) + ";";
+    }
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << rawHeap;
+    ASSERT_TRUE(CompressRawHeap(TEST_FILE_PATH, blockSize));
+    std::string content = ReadFileContent(TEST_FILE_PATH);
+    ASSERT_LT(content.size(), rawHeap.size());
+    RawHeapCompressTrailer trailer;
+    memcpy(&trailer, content.data() + content.size() - sizeof(trailer), sizeof(trailer));
+    ASSERT_EQ(trailer.magic, RAWHEAP_COMPRESS_MAGIC);
+    ASSERT_EQ(trailer.algorithm, RAWHEAP_COMPRESS_ZLIB);
+    ASSERT_EQ(trailer.rawSize, rawHeap.size());
+    ASSERT_EQ(trailer.blockCount, 4);
+    std::string restored;
+    for (uint32_t i = 0; i < trailer.blockCount; i++) {
+        RawHeapBlockIndex index;
+        memcpy(&index, content.data() + trailer.indexOffset + i * sizeof(index), sizeof(index));
+        std::string block(index.rawSize, '\0');
+        uLongf blockLen = index.rawSize;
+        ASSERT_EQ(uncompress(reinterpret_cast<Bytef*>(block.data()), &blockLen,
+            reinterpret_cast<const Bytef*>(content.data() + index.offset), index.compressedSize), Z_OK);
+        restored += block;
+    }
+    ASSERT_EQ(restored, rawHeap);
+    ASSERT_FALSE(CompressRawHeap(INVALID_FILE_PATH));
+}
+
+/**
+ * @tc.name: RawHeapDigestTest001
+ * @tc.desc: test the digest collected while finishing a rawheap matches the SHA-256 of the final file
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapDigestTest001, TestSize.Level1)
+{
+    RawHeapDigest abcDigest;
+    ASSERT_TRUE(abcDigest.Update("abc", strlen("abc")));
+    ASSERT_EQ(abcDigest.Final(), "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD");
+    char hex[DUMP_DIGEST_BUFFER_SIZE] = {0};
+    abcDigest.Reset();
+    ASSERT_TRUE(abcDigest.Update("abc", strlen("abc")));
+    ASSERT_TRUE(abcDigest.Final(hex, sizeof(hex)));
+    ASSERT_STREQ(hex, "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD");
+    abcDigest.Reset();
+    ASSERT_TRUE(abcDigest.Update("abc", strlen("abc")));
+    ASSERT_FALSE(abcDigest.Final(hex, sizeof(hex) - 1));
+    ASSERT_STREQ(hex, "");
+
+    std::string rawHeap;
+    for (uint32_t i = 0; rawHeap.size() < 10000; i++) {
+        rawHeap += "object" + std::to_string(i % 97) + ";";
+    }
+    std::ofstream(TEST_FILE_PATH, std::ios::binary) << rawHeap;
+    std::ofstream(TEST_META_FILE_PATH, std::ios::binary) << std::string(5000, 'm');
+    RawHeapMetaData rawHeapMetaData(TEST_META_FILE_PATH);
+    RawHeapDigest digest;
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH, META_DATA_INLINE, &digest));
+    ASSERT_EQ(digest.Final(), GetFileSHA256(TEST_FILE_PATH));
+
+    std::ofstream(TEST_FILE_PATH, std::ios::binary | std::ios::trunc) << rawHeap;
+    ASSERT_TRUE(CompressRawHeap(TEST_FILE_PATH, 4096, &digest));
+    ASSERT_GT(digest.Size(), 0);
+    ASSERT_TRUE(rawHeapMetaData.Append(TEST_FILE_PATH, META_DATA_INLINE, &digest));
+    std::string fileDigest = GetFileSHA256(TEST_FILE_PATH);
+    ASSERT_EQ(digest.Final(), fileDigest);
+    ASSERT_EQ(fileDigest.size(), 64);
+    ASSERT_EQ(GetFileSHA256(INVALID_FILE_PATH), "");
+}
+
+static void WriteDumpFile(const std::string& fileName, size_t size)
+{
+    std::ofstream(TEST_DUMP_DIR + "/" + fileName, std::ios::binary) << std::string(size, 'd');
+}
+
+static bool DumpFileExists(const std::string& fileName)
+{
+    return access((TEST_DUMP_DIR + "/" + fileName).c_str(), F_OK) == 0;
+}
+
+static void RemoveDumpFiles(const std::vector<std::string>& fileNames)
+{
+    for (const auto& fileName : fileNames) {
+        unlink((TEST_DUMP_DIR + "/" + fileName).c_str());
+    }
+    rmdir(TEST_DUMP_DIR.c_str());
+}
+
+/**
+ * @tc.name: DumpRetentionTest001
+ * @tc.desc: test unmatched rawheaps are dropped on the first dump and old dumps over the count limit later
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRetentionTest001, TestSize.Level1)
+{
+    const std::vector<std::string> files = { "jsleakwatcher-1-1-100.rawheap", "jsleakwatcher-1-1-200.rawheap",
+        "jsleakwatcher-1-1-200.jsleaklist", "jsleakwatcher-2-2-300.rawheap", "jsleakwatcher-2-2-300.jsleaklist",
+        "jsleakwatcher-2-2-400.rawheap", "jsleakwatcher-2-2-400.jsleaklist", "other.txt" };
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    for (const auto& file : files) {
+        WriteDumpFile(file, 10);
+    }
+    DumpRetentionManager retention;
+    retention.SetLimits(2, 0);
+    retention.PrepareDump(TEST_DUMP_DIR, "jsleakwatcher-2-2-", true);
+    retention.WaitIdle();
+    ASSERT_FALSE(DumpFileExists("jsleakwatcher-1-1-100.rawheap"));
+    ASSERT_TRUE(DumpFileExists("jsleakwatcher-1-1-200.rawheap"));
+    ASSERT_EQ(retention.GetDumpCount(TEST_DUMP_DIR), 3);
+
+    WriteDumpFile("jsleakwatcher-2-2-500.rawheap", 10);
+    WriteDumpFile("jsleakwatcher-2-2-500.jsleaklist", 10);
+    retention.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-2-2-500");
+    retention.WaitIdle();
+    ASSERT_EQ(retention.GetDumpCount(TEST_DUMP_DIR), 2);
+    ASSERT_FALSE(DumpFileExists("jsleakwatcher-1-1-200.jsleaklist"));
+    ASSERT_FALSE(DumpFileExists("jsleakwatcher-2-2-300.rawheap"));
+    ASSERT_TRUE(DumpFileExists("jsleakwatcher-2-2-400.rawheap"));
+    ASSERT_TRUE(DumpFileExists("other.txt"));
+
+    retention.PrepareDump(TEST_DUMP_DIR, "jsleakwatcher-2-2-", false);
+    retention.WaitIdle();
+    ASSERT_FALSE(DumpFileExists("jsleakwatcher-2-2-500.rawheap"));
+    ASSERT_FALSE(DumpFileExists("jsleakwatcher-2-2-500.jsleaklist"));
+    ASSERT_EQ(retention.GetDumpCount(TEST_DUMP_DIR), 1);
+    RemoveDumpFiles(files);
+}
+
+/**
+ * @tc.name: DumpRetentionTest002
+ * @tc.desc: test the byte quota removes the oldest dumps but always keeps the newest one
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRetentionTest002, TestSize.Level1)
+{
+    const std::vector<std::string> files = { "jsleakwatcher-1-1-100.rawheap", "jsleakwatcher-1-1-100.jsleaklist",
+        "jsleakwatcher-1-1-200.heapsnapshot", "jsleakwatcher-1-1-200.jsleaklist" };
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    WriteDumpFile(files[0], 1000);
+    WriteDumpFile(files[1], 100);
+    DumpRetentionManager retention;
+    retention.SetLimits(10, 1500);
+    retention.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-100");
+    retention.WaitIdle();
+    ASSERT_EQ(retention.GetTotalBytes(TEST_DUMP_DIR), 1100);
+
+    WriteDumpFile(files[2], 2000);
+    WriteDumpFile(files[3], 100);
+    retention.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-200");
+    retention.WaitIdle();
+    ASSERT_EQ(retention.GetDumpCount(TEST_DUMP_DIR), 1);
+    ASSERT_EQ(retention.GetTotalBytes(TEST_DUMP_DIR), 2100);
+    ASSERT_FALSE(DumpFileExists(files[0]));
+    ASSERT_TRUE(DumpFileExists(files[2]));
+    RemoveDumpFiles(files);
+}
+
+/**
+ * @tc.name: LeakWatcherSchedulerTest001
+ * @tc.desc: test ticks without registry changes are skipped and back off up to the configured interval
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakWatcherSchedulerTest001, TestSize.Level1)
+{
+    const uint32_t maxInterval = 80000;
+    LeakWatcherScheduler scheduler;
+    scheduler.SetMaxInterval(maxInterval);
+    ASSERT_TRUE(scheduler.OnTick(0, 0, 0));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval);
+    ASSERT_FALSE(scheduler.OnTick(0, 0, 0));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval);
+
+    ASSERT_TRUE(scheduler.OnTick(10, 0, 10));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval / 2);
+    ASSERT_TRUE(scheduler.OnTick(20, 0, 20));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval / 4);
+    for (uint32_t i = 0; i < GC_INTERVAL_TIGHTEN_LIMIT; i++) {
+        ASSERT_TRUE(scheduler.OnTick(30 + i, 0, 30 + i));
+    }
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval / GC_INTERVAL_TIGHTEN_LIMIT);
+
+    ASSERT_FALSE(scheduler.OnTick(37, 0, 37));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval / 4);
+    ASSERT_TRUE(scheduler.OnTick(37, 5, 32));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval / 2);
+    ASSERT_FALSE(scheduler.OnTick(37, 5, 32));
+    ASSERT_FALSE(scheduler.OnTick(37, 5, 32));
+    ASSERT_EQ(scheduler.GetInterval(), maxInterval);
+
+    scheduler.Reset();
+    ASSERT_TRUE(scheduler.OnTick(37, 5, 32));
+}
+
+/**
+ * @tc.name: LeakWatcherSchedulerTest002
+ * @tc.desc: test the registry counters seen by the scheduler count every add, remove and clear
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakWatcherSchedulerTest002, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    ASSERT_TRUE(registry.Add(1, "Foo", ""));
+    ASSERT_TRUE(registry.Add(2, "Foo", ""));
+    ASSERT_FALSE(registry.Add(2, "Foo", ""));
+    ASSERT_TRUE(registry.Remove(1));
+    ASSERT_FALSE(registry.Remove(1));
+    ASSERT_EQ(registry.GetBirthCount(), 2);
+    ASSERT_EQ(registry.GetDeathCount(), 1);
+    registry.Clear();
+    ASSERT_EQ(registry.GetDeathCount(), 2);
+
+    auto handler = GetTestHandler();
+    ASSERT_NE(handler, nullptr);
+    handler->SetGcDelayTime(DEFAULT_GC_INTERVAL);
+    ASSERT_EQ(handler->GetGcDelayTime(), DEFAULT_GC_INTERVAL);
+}
+
+/**
+ * @tc.name: LeakThresholdGateTest001
+ * @tc.desc: test GC ticks are gated by the threshold of the cached application state
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakThresholdGateTest001, TestSize.Level1)
+{
+    LeakThresholdGate gate;
+    ASSERT_FALSE(gate.IsBelowThreshold(0));
+    gate.SetThresholds(5, 1);
+    ASSERT_FALSE(gate.IsBelowThreshold(0));
+    gate.SetAppState(APP_STATE_FOREGROUND);
+    ASSERT_TRUE(gate.IsBelowThreshold(4));
+    ASSERT_FALSE(gate.IsBelowThreshold(5));
+    gate.SetAppState(APP_STATE_BACKGROUND);
+    ASSERT_TRUE(gate.IsBelowThreshold(0));
+    ASSERT_FALSE(gate.IsBelowThreshold(1));
+    gate.SetRetryPending(true);
+    ASSERT_FALSE(gate.IsBelowThreshold(0));
+    gate.SetRetryPending(false);
+    gate.Reset();
+    ASSERT_FALSE(gate.IsBelowThreshold(0));
+    ASSERT_EQ(gate.GetAppState(), APP_STATE_BACKGROUND);
+}
+
+/**
+ * @tc.name: DumpRequestPoolTest001
+ * @tc.desc: test dump request slots are reused with fresh request ids
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRequestPoolTest001, TestSize.Level1)
+{
+    DumpRequestPool pool;
+    int callbacks[DUMP_REQUEST_SLOT_COUNT] = {0};
+    std::vector<DumpRequestSlot*> slots;
+    for (uint32_t i = 0; i < DUMP_REQUEST_SLOT_COUNT; i++) {
+        DumpRequestSlot* slot = pool.Acquire(&callbacks[i]);
+        ASSERT_NE(slot, nullptr);
+        ASSERT_EQ(slot->callback, &callbacks[i]);
+        slots.push_back(slot);
+    }
+    ASSERT_EQ(pool.GetPendingCount(), DUMP_REQUEST_SLOT_COUNT);
+    ASSERT_EQ(pool.Acquire(nullptr), nullptr);
+
+    DumpRequestSlot* first = slots[0];
+    uint32_t firstId = first->requestId;
+    first->retcode = 1;
+    ASSERT_EQ(strcpy_s(first->digest, sizeof(first->digest), "ABCD"), EOK);
+    first->deferred = &callbacks[1];
+    first->env = &callbacks[2];
+    first->channelId = 1;
+    ASSERT_TRUE(first->SetFilePath(TEST_FILE_PATH));
+    ASSERT_STREQ(first->filePath, TEST_FILE_PATH.c_str());
+    ASSERT_FALSE(first->SetFilePath(std::string(PATH_MAX, 'a')));
+    ASSERT_STREQ(first->filePath, "");
+    ASSERT_TRUE(first->SetFilePath(TEST_FILE_PATH));
+    first->fileSize = 1;
+    pool.Release(first);
+    pool.Release(nullptr);
+    ASSERT_EQ(pool.GetPendingCount(), DUMP_REQUEST_SLOT_COUNT - 1);
+    DumpRequestSlot* reused = pool.Acquire(&callbacks[0]);
+    ASSERT_EQ(reused, first);
+    ASSERT_NE(reused->requestId, firstId);
+    ASSERT_EQ(reused->retcode, 0);
+    ASSERT_STREQ(reused->digest, "");
+    ASSERT_EQ(reused->deferred, nullptr);
+    ASSERT_EQ(reused->env, nullptr);
+    ASSERT_EQ(reused->channelId, 0);
+    ASSERT_STREQ(reused->filePath, "");
+    ASSERT_EQ(reused->fileSize, 0);
+    for (auto slot : slots) {
+        pool.Release(slot);
+    }
+    ASSERT_EQ(pool.GetPendingCount(), 0);
+}
+
+static std::string MakeHeapContent(size_t size, uint32_t seed)
+{
+    std::string content(size, '\0');
+    uint32_t state = seed;
+    for (auto& byte : content) {
+        state = state * 1103515245 + 12345; // LCG constants
+        byte = static_cast<char>(state >> 16);
+    }
+    return content;
+}
+
+static std::string RestoreDelta(const std::string& delta, const std::string& base)
+{
+    RawHeapDeltaTrailer trailer;
+    memcpy(&trailer, delta.data() + delta.size() - sizeof(trailer), sizeof(trailer));
+    std::string restored;
+    for (uint32_t i = 0; i < trailer.chunkCount; i++) {
+        RawHeapDeltaChunk chunk;
+        memcpy(&chunk, delta.data() + trailer.recipeOffset + i * sizeof(chunk), sizeof(chunk));
+        const std::string& source = chunk.source == DELTA_SOURCE_BASE ? base : delta;
+        restored.append(source, chunk.offset, chunk.size);
+    }
+    return restored;
+}
+
+/**
+ * @tc.name: RawHeapDeltaTest001
+ * @tc.desc: test a dump is stored as a delta against the base and restores byte for byte
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, RawHeapDeltaTest001, TestSize.Level1)
+{
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    const std::string basePath = TEST_DUMP_DIR + "/jsleakwatcher-1-1-100.rawheap";
+    const std::string nextPath = TEST_DUMP_DIR + "/jsleakwatcher-1-1-200.rawheap";
+    std::string base = MakeHeapContent(2 * 1024 * 1024, 1);
+    std::string next = base;
+    next.insert(512 * 1024, MakeHeapContent(100, 2));
+    next.replace(1536 * 1024, 16, MakeHeapContent(16, 3));
+    std::ofstream(basePath, std::ios::binary) << base;
+    std::ofstream(nextPath, std::ios::binary) << next;
+
+    RawHeapDeltaEncoder encoder;
+    bool isBase = false;
+    std::string usedBase;
+    ASSERT_TRUE(encoder.Encode(basePath, isBase, usedBase));
+    ASSERT_TRUE(isBase);
+    ASSERT_EQ(usedBase, basePath);
+    ASSERT_EQ(encoder.GetBasePath(), basePath);
+    ASSERT_EQ(ReadFileContent(basePath), base);
+    ASSERT_TRUE(encoder.Encode(nextPath, isBase, usedBase));
+    ASSERT_FALSE(isBase);
+    ASSERT_EQ(usedBase, basePath);
+
+    std::string delta = ReadFileContent(nextPath);
+    ASSERT_LT(delta.size(), next.size() / 4);
+    RawHeapDeltaTrailer trailer;
+    memcpy(&trailer, delta.data() + delta.size() - sizeof(trailer), sizeof(trailer));
+    ASSERT_EQ(trailer.magic, RAWHEAP_DELTA_MAGIC);
+    ASSERT_EQ(trailer.rawSize, next.size());
+    ASSERT_EQ(delta.substr(trailer.recipeOffset - trailer.baseNameSize, trailer.baseNameSize),
+        "jsleakwatcher-1-1-100.rawheap");
+    ASSERT_EQ(RestoreDelta(delta, base), next);
+
+    unlink(basePath.c_str());
+    std::ofstream(nextPath, std::ios::binary) << next;
+    ASSERT_TRUE(encoder.Encode(nextPath, isBase, usedBase));
+    ASSERT_TRUE(isBase);
+    ASSERT_EQ(usedBase, nextPath);
+    ASSERT_EQ(ReadFileContent(nextPath), next);
+    RemoveDumpFiles({"jsleakwatcher-1-1-200.rawheap"});
+}
+
+/**
+ * @tc.name: DumpRetentionTest003
+ * @tc.desc: test the pinned delta base survives both removal rules
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRetentionTest003, TestSize.Level1)
+{
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    std::vector<std::string> files;
+    for (const char* name : {"jsleakwatcher-1-1-100", "jsleakwatcher-1-1-200", "jsleakwatcher-1-1-300"}) {
+        files.push_back(std::string(name) + ".rawheap");
+        files.push_back(std::string(name) + ".jsleaklist");
+    }
+    for (size_t i = 0; i < 2; i++) {
+        WriteDumpFile(files[i], 10);
+    }
+    DumpRetentionManager manager;
+    manager.SetLimits(1, 0);
+    manager.PinDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-100");
+    manager.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-100");
+    WriteDumpFile(files[2], 10);
+    WriteDumpFile(files[3], 10);
+    manager.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-200");
+    manager.WaitIdle();
+    ASSERT_TRUE(DumpFileExists(files[0]));
+    ASSERT_TRUE(DumpFileExists(files[2]));
+
+    manager.PrepareDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-", false);
+    WriteDumpFile(files[4], 10);
+    WriteDumpFile(files[5], 10);
+    manager.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-300");
+    manager.WaitIdle();
+    ASSERT_TRUE(DumpFileExists(files[0]));
+    ASSERT_FALSE(DumpFileExists(files[2]));
+    ASSERT_TRUE(DumpFileExists(files[4]));
+    ASSERT_EQ(manager.GetDumpCount(TEST_DUMP_DIR), 2);
+    RemoveDumpFiles(files);
+}
+
+/**
+ * @tc.name: DumpRetentionTest004
+ * @tc.desc: test the rawheap created right after the first prepare is not taken for a leftover
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRetentionTest004, TestSize.Level1)
+{
+    const std::vector<std::string> files = { "jsleakwatcher-1-1-100.rawheap", "jsleakwatcher-1-1-200.rawheap",
+        "jsleakwatcher-1-1-200.jsleaklist" };
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    WriteDumpFile(files[0], 10);
+    DumpRetentionManager manager;
+    manager.PrepareDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-", true);
+    WriteDumpFile(files[1], 10);
+    manager.WaitIdle();
+    ASSERT_FALSE(DumpFileExists(files[0]));
+    ASSERT_TRUE(DumpFileExists(files[1]));
+
+    WriteDumpFile(files[2], 10);
+    manager.CommitDump(TEST_DUMP_DIR, "jsleakwatcher-1-1-200");
+    manager.WaitIdle();
+    ASSERT_EQ(manager.GetDumpCount(TEST_DUMP_DIR), 1);
+    RemoveDumpFiles(files);
+}
+
+/**
+ * @tc.name: DumpRetentionTest005
+ * @tc.desc: test a base replaced by a rebase is removed only after the deltas written against it
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, DumpRetentionTest005, TestSize.Level1)
+{
+    mkdir(TEST_DUMP_DIR.c_str(), S_IRWXU);
+    const std::vector<std::string> names = { "jsleakwatcher-1-1-100", "jsleakwatcher-1-1-200",
+        "jsleakwatcher-1-1-300", "jsleakwatcher-1-1-400", "jsleakwatcher-1-1-500", "jsleakwatcher-1-1-600" };
+    std::vector<std::string> files;
+    for (const auto& name : names) {
+        files.push_back(name + ".rawheap");
+        files.push_back(name + ".jsleaklist");
+    }
+    DumpRetentionManager manager;
+    manager.SetLimits(2, 0);
+    auto commit = [&manager, &files](size_t index) {
+        // the first listing of the directory must not see dumps that are not linked yet
+        manager.WaitIdle();
+        WriteDumpFile(files[index * 2], 10);
+        WriteDumpFile(files[index * 2 + 1], 10);
+        manager.CommitDump(TEST_DUMP_DIR, files[index * 2].substr(0, files[index * 2].rfind('.')));
+    };
+    manager.PinDump(TEST_DUMP_DIR, names[0]);
+    commit(0);
+    manager.LinkDelta(TEST_DUMP_DIR, names[1], names[0]);
+    commit(1);
+    manager.LinkDelta(TEST_DUMP_DIR, names[2], names[0]);
+    commit(2);
+    // rebase, the old base is no longer pinned but its two deltas still need it
+    manager.PinDump(TEST_DUMP_DIR, names[3]);
+    commit(3);
+    manager.LinkDelta(TEST_DUMP_DIR, names[4], names[3]);
+    commit(4);
+    manager.WaitIdle();
+    ASSERT_TRUE(DumpFileExists(files[0]));
+    ASSERT_FALSE(DumpFileExists(files[2]));
+    ASSERT_TRUE(DumpFileExists(files[4]));
+
+    manager.LinkDelta(TEST_DUMP_DIR, names[5], names[3]);
+    commit(5);
+    manager.WaitIdle();
+    ASSERT_FALSE(DumpFileExists(files[4]));
+    ASSERT_FALSE(DumpFileExists(files[0]));
+    ASSERT_FALSE(DumpFileExists(files[1]));
+    for (size_t index = 3; index < names.size(); index++) {
+        ASSERT_TRUE(DumpFileExists(files[index * 2]));
+    }
+    ASSERT_EQ(manager.GetDumpCount(TEST_DUMP_DIR), 3);
+    RemoveDumpFiles(files);
+}
+
+/**
+ * @tc.name: LeakListWriterTest001
+ * @tc.desc: test the streamed leak list matches the JSON.stringify layout across buffer flushes
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListWriterTest001, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    registry.Add(0xFFFFFFFF, "Quote\"Back\\slash", "line\n\ttab\x01");
+    std::string text;
+    LeakListWriter writer(text);
+    writer.Begin("2.0.0", "abc");
+    ASSERT_EQ(WriteLeakObjects(writer, registry), 1);
+    ASSERT_TRUE(writer.End());
+    ASSERT_EQ(text, "{\"version\":\"2.0.0\",\"snapshot_hash\":\"abc\",\"leakObjList\":[{\"hash\":-1,"
+        "\"name\":\"Quote\\\"Back\\\\slash\",\"msg\":\"line\\n\\ttab\\u0001\"}]}");
+    ASSERT_EQ(writer.GetWrittenSize(), text.size());
+
+    std::vector<uint32_t> hashes = {2, 0xFFFFFFFF, 1};
+    text.clear();
+    LeakListWriter listWriter(text);
+    listWriter.BeginArray();
+    ASSERT_EQ(WriteLeakObjects(listWriter, registry, &hashes), 1);
+    listWriter.EndArray();
+    ASSERT_EQ(text, "[{\"hash\":-1,\"name\":\"Quote\\\"Back\\\\slash\",\"msg\":\"line\\n\\ttab\\u0001\"}]");
+
+    const uint32_t count = 4096;
+    for (uint32_t i = 1; i <= count; i++) {
+        registry.Add(i, "LeakObject" + std::to_string(i % 16), "watched message");
+    }
+    std::string expected;
+    LeakListWriter expectedWriter(expected);
+    expectedWriter.Begin("", "");
+    WriteLeakObjects(expectedWriter, registry);
+    expectedWriter.End();
+    ASSERT_GT(expected.size(), LEAK_LIST_WRITE_BUFFER_SIZE);
+    std::string header = "{\"snapshot_hash\":\"\",\"leakObjList\":[";
+    ASSERT_EQ(expected.compare(0, header.size(), header), 0);
+
+    int fd = open(TEST_FILE_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    LeakListWriter fileWriter(fd);
+    fileWriter.Begin("", "");
+    ASSERT_EQ(WriteLeakObjects(fileWriter, registry), count + 1);
+    ASSERT_TRUE(fileWriter.End());
+    close(fd);
+    ASSERT_EQ(fileWriter.GetWrittenSize(), expected.size());
+    ASSERT_EQ(ReadFileContent(TEST_FILE_PATH), expected);
+    std::remove(TEST_FILE_PATH.c_str());
+}
+
+/**
+ * @tc.name: LeakListBinaryTest001
+ * @tc.desc: test the binary leak list round trips and exports the same JSON as the streamed writer
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListBinaryTest001, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    const uint32_t count = 1000;
+    for (uint32_t i = 1; i <= count; i++) {
+        registry.Add(i * 7919, "LeakObject" + std::to_string(i % 8), i % 2 == 0 ? "" : "msg\n", 1000 + i);
+    }
+    int fd = open(TEST_FILE_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    uint64_t size = 0;
+    ASSERT_TRUE(WriteBinaryLeakList(fd, registry, "2.0.0", "abc", size));
+    close(fd);
+    std::string content = ReadFileContent(TEST_FILE_PATH);
+    ASSERT_EQ(content.size(), size);
+
+    BinaryLeakList list;
+    ASSERT_TRUE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+    // version, snapshot hash, 8 names and 2 messages
+    ASSERT_EQ(list.strings.size(), 12);
+    ASSERT_EQ(list.records.size(), count);
+    LeakObjectInfo info;
+    for (const LeakListBinaryRecord& record : list.records) {
+        ASSERT_TRUE(registry.Find(record.hash, info));
+        ASSERT_EQ(record.timestamp, info.timestamp);
+        ASSERT_EQ(list.strings[record.nameIndex], registry.GetString(info.nameId));
+        ASSERT_EQ(list.strings[record.msgIndex], registry.GetString(info.msgId));
+    }
+
+    std::string expected;
+    LeakListWriter expectedWriter(expected);
+    expectedWriter.Begin("2.0.0", "abc");
+    WriteLeakObjects(expectedWriter, registry);
+    expectedWriter.End();
+    std::string exported;
+    LeakListWriter exportWriter(exported);
+    ASSERT_TRUE(ExportLeakListJson(list, exportWriter));
+    ASSERT_EQ(exported, expected);
+    ASSERT_LT(content.size(), expected.size());
+
+    content[0] = '{';
+    std::ofstream(TEST_FILE_PATH, std::ios::binary | std::ios::trunc) << content;
+    ASSERT_FALSE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+    std::remove(TEST_FILE_PATH.c_str());
+}
+
+/**
+ * @tc.name: LeakListBinaryTest002
+ * @tc.desc: test counts and lengths of a corrupt binary leak list are rejected before they are allocated
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakListBinaryTest002, TestSize.Level1)
+{
+    auto writeList = [](const LeakListBinaryHeader& header, const std::string& body) {
+        std::string content(reinterpret_cast<const char*>(&header), sizeof(header));
+        std::ofstream(TEST_FILE_PATH, std::ios::binary | std::ios::trunc) << content + body;
+    };
+    const uint32_t hugeLength = 0xFFFFFFF0;
+    const std::string lengthBytes(reinterpret_cast<const char*>(&hugeLength), sizeof(hugeLength));
+    BinaryLeakList list;
+    LeakListBinaryHeader header;
+    header.stringCount = UINT32_MAX;
+    writeList(header, lengthBytes);
+    ASSERT_FALSE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+
+    header.stringCount = 1;
+    writeList(header, lengthBytes + "abc");
+    ASSERT_FALSE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+
+    header.stringCount = 0;
+    header.recordCount = UINT32_MAX;
+    writeList(header, std::string(sizeof(LeakListBinaryRecord), '\0'));
+    ASSERT_FALSE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+    ASSERT_TRUE(list.records.empty());
+
+    LeakObjectRegistry registry;
+    registry.Add(1, "LeakObject", "", 1);
+    int fd = open(TEST_FILE_PATH.c_str(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_GE(fd, 0);
+    uint64_t size = 0;
+    ASSERT_TRUE(WriteBinaryLeakList(fd, registry, "", "abc", size));
+    close(fd);
+    ASSERT_TRUE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+    ASSERT_EQ(truncate(TEST_FILE_PATH.c_str(), static_cast<off_t>(size - 1)), 0);
+    ASSERT_FALSE(ReadBinaryLeakList(TEST_FILE_PATH, list));
+    std::remove(TEST_FILE_PATH.c_str());
+}
+
+/**
+ * @tc.name: LeakReportTest001
+ * @tc.desc: test the leak report summarizes the most frequent classes
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakReportTest001, TestSize.Level1)
+{
+    LeakObjectRegistry registry;
+    std::vector<uint32_t> hashes;
+    const uint32_t classCount = 12;
+    uint32_t hash = 1;
+    for (uint32_t i = 1; i <= classCount; i++) {
+        for (uint32_t j = 0; j < i; j++) {
+            registry.Add(hash, "Class" + std::to_string(i), "");
+            hashes.push_back(hash++);
+        }
+    }
+    registry.Add(hash, "Quote\"", "");
+    registry.Add(hash + 1, "Class12", "");
+    hashes.push_back(hash);
+    hashes.push_back(hash + 2);
+    std::string summary;
+    ASSERT_EQ(BuildLeakClassSummary(registry, hashes, 2, summary), 79);
+    ASSERT_EQ(summary, "[{\"name\":\"Class12\",\"count\":12},{\"name\":\"Class11\",\"count\":11}]");
+    summary.clear();
+    std::vector<uint32_t> tied = {1, 2, 3, 4, hash};
+    ASSERT_EQ(BuildLeakClassSummary(registry, tied, LEAK_REPORT_TOP_CLASSES, summary), 5);
+    ASSERT_EQ(summary, "[{\"name\":\"Class2\",\"count\":2},{\"name\":\"Class1\",\"count\":1},"
+        "{\"name\":\"Class3\",\"count\":1},{\"name\":\"Quote\\\"\",\"count\":1}]");
+    summary.clear();
+    ASSERT_EQ(BuildLeakClassSummary(registry, {}, LEAK_REPORT_TOP_CLASSES, summary), 0);
+    ASSERT_EQ(summary, "[]");
+}
+
+/**
+ * @tc.name: LeakReportTest002
+ * @tc.desc: test the report worker writes in order and drops the oldest reports once full
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, LeakReportTest002, TestSize.Level1)
+{
+    std::mutex lock;
+    std::condition_variable cond;
+    bool started = false;
+    bool released = false;
+    std::vector<int32_t> written;
+    LeakReportWorker worker([&](const LeakReport& report) {
+        std::unique_lock<std::mutex> guard(lock);
+        started = true;
+        cond.notify_all();
+        cond.wait(guard, [&released] { return released; });
+        written.push_back(report.pid);
+        return 0;
+    });
+    LeakReport report;
+    worker.Submit(report);
+    {
+        // the worker holds the first report, the following ones stay queued
+        std::unique_lock<std::mutex> guard(lock);
+        cond.wait(guard, [&started] { return started; });
+    }
+    const int32_t submitted = static_cast<int32_t>(LEAK_REPORT_QUEUE_CAPACITY) + 2;
+    for (int32_t pid = 1; pid <= submitted; pid++) {
+        report.pid = pid;
+        worker.Submit(report);
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        released = true;
+    }
+    cond.notify_all();
+    worker.WaitIdle();
+    ASSERT_EQ(worker.GetDroppedCount(), 2);
+    std::vector<int32_t> expected = {0};
+    for (int32_t pid = 3; pid <= submitted; pid++) {
+        expected.push_back(pid);
+    }
+    ASSERT_EQ(written, expected);
+}
+
+/**
+ * @tc.name: WatchLifecycleObjectTest001
+ * @tc.desc: test the target of the WeakRef from the ArkUI lifecycle hook is watched on flush, not the WeakRef
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherNapiTest, WatchLifecycleObjectTest001, TestSize.Level1)
+{
+    panda::RuntimeOption option;
+    option.SetGcType(panda::RuntimeOption::GC_TYPE::GEN_GC);
+    option.SetLogLevel(panda::RuntimeOption::LOG_LEVEL::ERROR);
+    panda::EcmaVM* vm = panda::JSNApi::CreateJSVM(option);
+    ASSERT_NE(vm, nullptr);
+    auto engine = new ArkNativeEngine(vm, nullptr);
+    napi_env env = reinterpret_cast<napi_env>(engine);
+    napi_handle_scope scope = nullptr;
+    napi_open_handle_scope(env, &scope);
+
+    napi_value nodeClass = nullptr;
+    napi_value node = nullptr;
+    napi_value global = nullptr;
+    napi_value weakRefClass = nullptr;
+    napi_value weakRef = nullptr;
+    ASSERT_EQ(napi_define_class(env, "NodeContainer", NAPI_AUTO_LENGTH, TestObjectConstructor, nullptr, 0, nullptr,
+        &nodeClass), napi_ok);
+    ASSERT_EQ(napi_new_instance(env, nodeClass, 0, nullptr, &node), napi_ok);
+    ASSERT_EQ(napi_get_global(env, &global), napi_ok);
+    ASSERT_EQ(napi_get_named_property(env, global, "WeakRef", &weakRefClass), napi_ok);
+    napi_value argv[1] = {node};
+    ASSERT_EQ(napi_new_instance(env, weakRefClass, 1, argv, &weakRef), napi_ok);
+
+    LeakObjectRegistry& registry = GetTestLeakRegistry();
+    registry.Clear();
+    ASSERT_TRUE(TestWatchLifecycleObject(env, weakRef));
+    // registration waits for the flush behind the current UI task
+    ASSERT_EQ(registry.Size(), 0);
+    TestFlushLifecycleBatch(env);
+    LeakObjectInfo info;
+    ASSERT_TRUE(registry.Find(static_cast<uint32_t>(engine->GetObjectHash(env, node)), info));
+    ASSERT_EQ(registry.GetString(info.nameId), "NodeContainer");
+    ASSERT_FALSE(registry.Contains(static_cast<uint32_t>(engine->GetObjectHash(env, weakRef))));
+    ASSERT_EQ(registry.Size(), 1);
+
+    napi_value undefined = nullptr;
+    napi_get_undefined(env, &undefined);
+    ASSERT_FALSE(TestWatchLifecycleObject(env, undefined));
+    ASSERT_FALSE(TestWatchLifecycleObject(env, node));
+    TestFlushLifecycleBatch(env);
+    ASSERT_EQ(registry.Size(), 1);
+    registry.Clear();
+
+    napi_close_handle_scope(env, scope);
+    delete engine;
+    panda::JSNApi::DestroyJSVM(vm);
+}
 } // namespace HiviewDFX
 } // namespace OHOS
@@ -14,9 +14,15 @@
  */
 
 #include "js_leak_watcher_ts.h"
+#include <cstdlib>
 #include <string>
 #include <gtest/gtest.h>
+#include "event_handler.h"
+#include "event_runner.h"
 #include "hichecker.h"
+#include "hichecker_param_cache.h"
+#include "native_engine/impl/ark/ark_native_engine.h"
+#include "parameters.h"
 
 using namespace testing::ext;
 
@@ -340,5 +346,101 @@ HWTEST_F(JsLeakWatcherTsTest, EnableStatusIntegrationTest003, TestSize.Level1)
     SetjsLeakWatcherEnableStatus(ret);
     ASSERT_FALSE(GetjsLeakWatcherEnableStatus());
 }
+
+/**
+ * @tc.name: HiCheckerParamCacheTest001
+ * @tc.desc: test the cached parameters follow a change of the parameter value
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherTsTest, HiCheckerParamCacheTest001, TestSize.Level1)
+{
+    const char* checkName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_CHECK);
+    std::string oldCheck = OHOS::system::GetParameter(checkName, "");
+    ASSERT_TRUE(OHOS::system::SetParameter(checkName, "enable.com.example.cache"));
+    ASSERT_TRUE(TestCheckJsLeakWatcherParam("com.example.cache"));
+    ASSERT_FALSE(TestCheckJsLeakWatcherParam("com.example.cach"));
+    ASSERT_FALSE(TestCheckJsLeakWatcherParam("com.example.cache2"));
+    ASSERT_TRUE(OHOS::system::SetParameter(checkName, "disable.com.example.cache"));
+    ASSERT_FALSE(TestCheckJsLeakWatcherParam("com.example.cache"));
+    OHOS::system::SetParameter(checkName, oldCheck);
+
+    const char* quotaName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_DUMP_QUOTA);
+    std::string oldQuota = OHOS::system::GetParameter(quotaName, "0");
+    ASSERT_TRUE(OHOS::system::SetParameter(quotaName, "64"));
+    ASSERT_EQ(HiCheckerParamCache::GetUint64(HiCheckerParam::JSLEAK_DUMP_QUOTA), 64);
+    ASSERT_EQ(HiCheckerParamCache::GetString(HiCheckerParam::JSLEAK_DUMP_QUOTA), "64");
+    ASSERT_TRUE(OHOS::system::SetParameter(quotaName, "128"));
+    ASSERT_EQ(HiCheckerParamCache::GetUint64(HiCheckerParam::JSLEAK_DUMP_QUOTA), 128);
+    OHOS::system::SetParameter(quotaName, oldQuota);
+
+    const char* dumpName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_DUMP);
+    std::string oldDump = OHOS::system::GetParameter(dumpName, "true");
+    ASSERT_TRUE(OHOS::system::SetParameter(dumpName, "false"));
+    ASSERT_FALSE(HiCheckerParamCache::GetBool(HiCheckerParam::JSLEAK_DUMP));
+    ASSERT_TRUE(OHOS::system::SetParameter(dumpName, "unknown"));
+    ASSERT_TRUE(HiCheckerParamCache::GetBool(HiCheckerParam::JSLEAK_DUMP));
+    OHOS::system::SetParameter(dumpName, oldDump);
+}
+
+/**
+ * @tc.name: JSLeakWatcherEarlyInitDeferred001
+ * @tc.desc: test the deferred init mode is read from the cached parameter and keeps the disabled status
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherTsTest, JSLeakWatcherEarlyInitDeferred001, TestSize.Level1)
+{
+    const char* deferredName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_INIT_DEFERRED);
+    std::string oldDeferred = OHOS::system::GetParameter(deferredName, "false");
+    ASSERT_TRUE(OHOS::system::SetParameter(deferredName, "true"));
+    ASSERT_TRUE(HiCheckerParamCache::GetBool(HiCheckerParam::JSLEAK_INIT_DEFERRED));
+    SetjsLeakWatcherEnableStatus(true);
+    JSLeakWatcherEarlyInit(nullptr, "com.test.deferred");
+    EXPECT_FALSE(GetjsLeakWatcherEnableStatus());
+    OHOS::system::SetParameter(deferredName, oldDeferred);
+}
+
+/**
+ * @tc.name: JSLeakWatcherEarlyInitDeferred002
+ * @tc.desc: test the deferred init of an enabled bundle runs on the main runner after the init returns
+ * @tc.type: FUNC
+ */
+HWTEST_F(JsLeakWatcherTsTest, JSLeakWatcherEarlyInitDeferred002, TestSize.Level1)
+{
+    const char* checkName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_CHECK);
+    const char* deferredName = HiCheckerParamCache::GetName(HiCheckerParam::JSLEAK_INIT_DEFERRED);
+    std::string oldCheck = OHOS::system::GetParameter(checkName, "");
+    std::string oldDeferred = OHOS::system::GetParameter(deferredName, "false");
+    ASSERT_TRUE(OHOS::system::SetParameter(checkName, "enable.com.test.deferred"));
+    ASSERT_TRUE(OHOS::system::SetParameter(deferredName, "true"));
+    setenv("HAP_DEBUGGABLE", "true", 1);
+
+    panda::RuntimeOption option;
+    option.SetGcType(panda::RuntimeOption::GC_TYPE::GEN_GC);
+    option.SetLogLevel(panda::RuntimeOption::LOG_LEVEL::ERROR);
+    panda::EcmaVM* vm = panda::JSNApi::CreateJSVM(option);
+    ASSERT_NE(vm, nullptr);
+    auto engine = new ArkNativeEngine(vm, nullptr);
+    napi_env env = reinterpret_cast<napi_env>(engine);
+
+    uint32_t count = TestGetDeferredInitCount();
+    JSLeakWatcherEarlyInit(env, "com.test.deferred");
+    EXPECT_TRUE(GetjsLeakWatcherEnableStatus());
+    // nothing is loaded until the main runner is idle
+    EXPECT_EQ(TestGetDeferredInitCount(), count);
+
+    auto runner = OHOS::AppExecFwk::EventRunner::GetMainEventRunner();
+    ASSERT_NE(runner, nullptr);
+    auto handler = std::make_shared<OHOS::AppExecFwk::EventHandler>(runner);
+    handler->PostTask([runner] { runner->Stop(); }, "JSLeakWatcherDeferredStop", 0,
+        OHOS::AppExecFwk::EventHandler::Priority::IDLE);
+    runner->Run();
+    EXPECT_EQ(TestGetDeferredInitCount(), count + 1);
+
+    unsetenv("HAP_DEBUGGABLE");
+    OHOS::system::SetParameter(checkName, oldCheck);
+    OHOS::system::SetParameter(deferredName, oldDeferred);
+    delete engine;
+    panda::JSNApi::DestroyJSVM(vm);
+}
 } // namespace HiviewDFX
 } // namespace OHOS
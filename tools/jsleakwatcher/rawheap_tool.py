@@ -0,0 +1,526 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+# Copyright (C) 2025 Huawei Device Co., Ltd.
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Offline helpers for rawheap files written by jsLeakWatcher.
+
+A rawheap ends with [metadata][u32 rawHeapSize][u32 metaDataSize]. When the sidecar mode
+(hiviewdfx.hichecker.jsleakwatcher.rawheap.sidecar=true) is on, the metadata is replaced by a
+24 byte reference {magic "JLMR", u32 version, u64 fnv1a64, u32 size, u32 reserved} and the bytes live
+in jsleakwatcher_metadata_<hash>.json next to the dump.
+
+When hiviewdfx.hichecker.jsleakwatcher.rawheap.compress=true, the rawheap body is a run of zlib
+blocks followed by a {u64 offset, u32 compressedSize, u32 rawSize} index per block and a 40 byte
+trailer {magic "JLCZ", u32 version, u32 algorithm, u32 blockSize, u32 blockCount, u32 reserved,
+u64 rawSize, u64 indexOffset}.
+
+When hiviewdfx.hichecker.jsleakwatcher.rawheap.delta=true, a dump may be a delta against the base rawheap
+of the same directory: [new chunk bytes][base file name][{u64 hash, u64 offset, u32 size, u32 source}...]
+and a 32 byte trailer {magic "JLDL", u32 version, u32 chunkCount, u32 baseNameSize, u64 rawSize,
+u64 recipeOffset}. Source 0 copies the chunk from the base, 1 from the delta itself. Compression, when
+on, applies to the delta body.
+
+    rawheap_tool.py info <rawheap>
+    rawheap_tool.py extract <rawheap> --offset N --length N [-o OUTPUT]
+    rawheap_tool.py recombine <rawheap> [-s SIDECAR_DIR] [-o OUTPUT]
+    rawheap_tool.py merge <rawheap> [-b BASE_DIR] [-o OUTPUT]
+    rawheap_tool.py focus <heapsnapshot> <jsleaklist> [--ids ID,...] [-o OUTPUT]
+    rawheap_tool.py leaklist <jsleaklist> [-o OUTPUT]
+
+focus cuts a heapsnapshot (a .heapsnapshot dump, or a rawheap translated by rawheap_translator) down to
+the leaked objects, their shortest retainer paths from the root, ignoring weak edges, and the objects only
+they keep alive. Leaked objects are matched by the identity hash of the jsleaklist when the snapshot has a
+"hash" node field, or by the snapshot node ids given with --ids.
+
+When hiviewdfx.hichecker.jsleakwatcher.leaklist.binary=true, a jsleaklist is written in a binary layout:
+a 24 byte header {magic "JLLB", u16 version, u16 reserved, u32 stringCount, u32 recordCount,
+u32 versionIndex, u32 snapshotHashIndex}, stringCount strings as {u32 length, bytes}, then 24 byte
+records {u64 timestamp, u32 hash, u32 nameIndex, u32 msgIndex, u32 reserved}. A versionIndex of
+0xFFFFFFFF means the list has no version. leaklist converts a binary list to the JSON layout and a JSON
+list to the binary one; focus reads both.
+"""
+
+import argparse
+import collections
+import json
+import os
+import struct
+import sys
+import zlib
+
+FOOTER_FORMAT = "<II"
+FOOTER_SIZE = struct.calcsize(FOOTER_FORMAT)
+REF_FORMAT = "<4sIQII"
+REF_SIZE = struct.calcsize(REF_FORMAT)
+REF_MAGIC = b"JLMR"
+REF_VERSION = 1
+SIDECAR_PREFIX = "jsleakwatcher_metadata_"
+COMPRESS_FORMAT = "<4sIIIIIQQ"
+COMPRESS_SIZE = struct.calcsize(COMPRESS_FORMAT)
+COMPRESS_MAGIC = b"JLCZ"
+COMPRESS_ZLIB = 1
+BLOCK_INDEX_FORMAT = "<QII"
+BLOCK_INDEX_SIZE = struct.calcsize(BLOCK_INDEX_FORMAT)
+DELTA_FORMAT = "<4sIIIQQ"
+DELTA_SIZE = struct.calcsize(DELTA_FORMAT)
+DELTA_MAGIC = b"JLDL"
+DELTA_VERSION = 1
+DELTA_CHUNK_FORMAT = "<QQII"
+DELTA_CHUNK_SIZE = struct.calcsize(DELTA_CHUNK_FORMAT)
+DELTA_SOURCE_BASE = 0
+FNV_OFFSET_BASIS = 14695981039346656037
+FNV_PRIME = 1099511628211
+UINT64_MASK = (1 << 64) - 1
+LEAKLIST_FORMAT = "<4sHHIIII"
+LEAKLIST_SIZE = struct.calcsize(LEAKLIST_FORMAT)
+LEAKLIST_MAGIC = b"JLLB"
+LEAKLIST_VERSION = 1
+LEAKLIST_RECORD_FORMAT = "<QIIII"
+LEAKLIST_RECORD_SIZE = struct.calcsize(LEAKLIST_RECORD_FORMAT)
+LEAKLIST_NO_STRING = 0xFFFFFFFF
+
+
+def fnv1a64(data):
+    value = FNV_OFFSET_BASIS
+    for byte in data:
+        value = ((value ^ byte) * FNV_PRIME) & UINT64_MASK
+    return value
+
+
+def parse_rawheap(data):
+    if len(data) < FOOTER_SIZE:
+        raise ValueError("file too small for a rawheap footer")
+    raw_size, meta_size = struct.unpack_from(FOOTER_FORMAT, data, len(data) - FOOTER_SIZE)
+    if raw_size + meta_size + FOOTER_SIZE != len(data):
+        raise ValueError("footer does not match file size")
+    meta = data[raw_size:raw_size + meta_size]
+    ref = None
+    if meta_size == REF_SIZE and meta[:len(REF_MAGIC)] == REF_MAGIC:
+        _, version, content_hash, size, _ = struct.unpack(REF_FORMAT, meta)
+        ref = {"version": version, "hash": content_hash, "size": size}
+    return raw_size, meta, ref
+
+
+class RawHeapBody:
+    """Random access to the heap bytes of a rawheap body, compressed or not."""
+
+    def __init__(self, body):
+        self.body = body
+        self.blocks = None
+        self.block_size = 0
+        self.size = len(body)
+        if len(body) < COMPRESS_SIZE or body[-COMPRESS_SIZE:][:len(COMPRESS_MAGIC)] != COMPRESS_MAGIC:
+            return
+        _, _, algorithm, block_size, block_count, _, raw_size, index_offset = struct.unpack(
+            COMPRESS_FORMAT, body[-COMPRESS_SIZE:])
+        if algorithm != COMPRESS_ZLIB:
+            raise ValueError("unsupported compression algorithm %d" % algorithm)
+        self.blocks = [struct.unpack_from(BLOCK_INDEX_FORMAT, body, index_offset + i * BLOCK_INDEX_SIZE)
+                       for i in range(block_count)]
+        self.block_size = block_size
+        self.size = raw_size
+
+    @property
+    def compressed(self):
+        return self.blocks is not None
+
+    def read(self, offset, length):
+        if not self.compressed:
+            return self.body[offset:offset + length]
+        end = min(offset + length, self.size)
+        chunks = []
+        for index in range(offset // self.block_size, (end + self.block_size - 1) // self.block_size):
+            block_offset, compressed_size, _ = self.blocks[index]
+            block = zlib.decompress(self.body[block_offset:block_offset + compressed_size])
+            start = index * self.block_size
+            chunks.append(block[max(offset - start, 0):end - start])
+        return b"".join(chunks)
+
+
+def parse_delta(heap):
+    if len(heap) < DELTA_SIZE or heap[-DELTA_SIZE:][:len(DELTA_MAGIC)] != DELTA_MAGIC:
+        return None
+    _, version, chunk_count, name_size, raw_size, recipe_offset = struct.unpack(DELTA_FORMAT, heap[-DELTA_SIZE:])
+    if version != DELTA_VERSION:
+        raise ValueError("unsupported delta version %d" % version)
+    chunks = [struct.unpack_from(DELTA_CHUNK_FORMAT, heap, recipe_offset + i * DELTA_CHUNK_SIZE)
+              for i in range(chunk_count)]
+    base_name = heap[recipe_offset - name_size:recipe_offset].decode("utf-8")
+    new_bytes = sum(size for _, _, size, source in chunks if source != DELTA_SOURCE_BASE)
+    return {"base": base_name, "chunks": chunks, "raw_size": raw_size, "new_bytes": new_bytes}
+
+
+def load_heap(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    raw_size, meta, _ = parse_rawheap(data)
+    body = RawHeapBody(data[:raw_size])
+    return body.read(0, body.size), meta
+
+
+def restore_heap(path, base_dir):
+    """Returns the full heap bytes of a dump, following its delta base when it is one."""
+    heap, meta = load_heap(path)
+    delta = parse_delta(heap)
+    if delta is None:
+        return heap, meta
+    base_heap, _ = restore_heap(os.path.join(base_dir, delta["base"]), base_dir)
+    parts = []
+    for _, offset, size, source in delta["chunks"]:
+        source_heap = base_heap if source == DELTA_SOURCE_BASE else heap
+        if offset + size > len(source_heap):
+            raise ValueError("delta chunk outside of %s" % ("the base" if source == DELTA_SOURCE_BASE else "the dump"))
+        parts.append(source_heap[offset:offset + size])
+    full = b"".join(parts)
+    if len(full) != delta["raw_size"]:
+        raise ValueError("restored size does not match the delta trailer")
+    return full, meta
+
+
+def sidecar_name(content_hash):
+    return "%s%016x.json" % (SIDECAR_PREFIX, content_hash)
+
+
+def cmd_info(args):
+    with open(args.rawheap, "rb") as f:
+        data = f.read()
+    raw_size, meta, ref = parse_rawheap(data)
+    body = RawHeapBody(data[:raw_size])
+    print("rawheap size: %d" % raw_size)
+    if body.compressed:
+        print("compression: zlib, %d blocks of %d bytes, %d bytes inflated" %
+              (len(body.blocks), body.block_size, body.size))
+    delta = parse_delta(body.read(0, body.size)) if body.size >= DELTA_SIZE else None
+    if delta is not None:
+        print("delta: base %s, %d of %d bytes new in %d chunks" %
+              (delta["base"], delta["new_bytes"], delta["raw_size"], len(delta["chunks"])))
+    if ref is None:
+        print("metadata: inline, %d bytes" % len(meta))
+    else:
+        print("metadata: sidecar %s, version %d, %d bytes" % (sidecar_name(ref["hash"]), ref["version"], ref["size"]))
+    return 0
+
+
+def cmd_extract(args):
+    with open(args.rawheap, "rb") as f:
+        data = f.read()
+    raw_size, _, _ = parse_rawheap(data)
+    chunk = RawHeapBody(data[:raw_size]).read(args.offset, args.length)
+    if args.output:
+        with open(args.output, "wb") as f:
+            f.write(chunk)
+    else:
+        sys.stdout.buffer.write(chunk)
+    return 0
+
+
+def cmd_recombine(args):
+    with open(args.rawheap, "rb") as f:
+        data = f.read()
+    raw_size, meta, ref = parse_rawheap(data)
+    if ref is not None:
+        if ref["version"] != REF_VERSION:
+            print("unsupported metadata reference version %d" % ref["version"], file=sys.stderr)
+            return 1
+        sidecar_dir = args.sidecar_dir or os.path.dirname(os.path.abspath(args.rawheap))
+        with open(os.path.join(sidecar_dir, sidecar_name(ref["hash"])), "rb") as f:
+            meta = f.read()
+        if len(meta) != ref["size"] or fnv1a64(meta) != ref["hash"]:
+            print("sidecar content does not match the reference", file=sys.stderr)
+            return 1
+    body = RawHeapBody(data[:raw_size])
+    heap = body.read(0, body.size)
+    output = args.output or args.rawheap + ".full"
+    with open(output, "wb") as f:
+        f.write(heap)
+        f.write(meta)
+        f.write(struct.pack(FOOTER_FORMAT, len(heap), len(meta)))
+    print("written %s" % output)
+    return 0
+
+
+def cmd_merge(args):
+    base_dir = args.base_dir or os.path.dirname(os.path.abspath(args.rawheap))
+    try:
+        heap, meta = restore_heap(args.rawheap, base_dir)
+    except (OSError, ValueError) as error:
+        print("merge failed: %s" % error, file=sys.stderr)
+        return 1
+    output = args.output or args.rawheap + ".full"
+    with open(output, "wb") as f:
+        f.write(heap)
+        f.write(meta)
+        f.write(struct.pack(FOOTER_FORMAT, len(heap), len(meta)))
+    print("written %s" % output)
+    return 0
+
+
+def to_int32(value):
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def parse_binary_leaklist(data):
+    magic, version, _, string_count, record_count, version_index, hash_index = \
+        struct.unpack_from(LEAKLIST_FORMAT, data, 0)
+    if magic != LEAKLIST_MAGIC or version != LEAKLIST_VERSION:
+        raise ValueError("unsupported binary jsleaklist")
+    pos = LEAKLIST_SIZE
+    strings = []
+    for _ in range(string_count):
+        (length,) = struct.unpack_from("<I", data, pos)
+        strings.append(data[pos + 4:pos + 4 + length].decode("utf-8", "surrogateescape"))
+        pos += 4 + length
+    leak_list = collections.OrderedDict()
+    if version_index != LEAKLIST_NO_STRING:
+        leak_list["version"] = strings[version_index]
+    leak_list["snapshot_hash"] = strings[hash_index]
+    objects = []
+    for _ in range(record_count):
+        _, leak_hash, name_index, msg_index, _ = struct.unpack_from(LEAKLIST_RECORD_FORMAT, data, pos)
+        objects.append(collections.OrderedDict(
+            [("hash", to_int32(leak_hash)), ("name", strings[name_index]), ("msg", strings[msg_index])]))
+        pos += LEAKLIST_RECORD_SIZE
+    leak_list["leakObjList"] = objects
+    return leak_list
+
+
+def build_binary_leaklist(leak_list):
+    strings = []
+    index = {}
+
+    def intern(value):
+        if value not in index:
+            index[value] = len(strings)
+            strings.append(value)
+        return index[value]
+
+    version_index = intern(leak_list["version"]) if "version" in leak_list else LEAKLIST_NO_STRING
+    hash_index = intern(leak_list.get("snapshot_hash", ""))
+    records = [struct.pack(LEAKLIST_RECORD_FORMAT, 0, int(leak["hash"]) & 0xFFFFFFFF, intern(leak.get("name", "")),
+                           intern(leak.get("msg", "")), 0) for leak in leak_list.get("leakObjList", [])]
+    table = b"".join(struct.pack("<I", len(raw)) + raw
+                     for raw in (value.encode("utf-8", "surrogateescape") for value in strings))
+    header = struct.pack(LEAKLIST_FORMAT, LEAKLIST_MAGIC, LEAKLIST_VERSION, 0, len(strings), len(records),
+                         version_index, hash_index)
+    return header + table + b"".join(records)
+
+
+def load_leaklist(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:len(LEAKLIST_MAGIC)] == LEAKLIST_MAGIC:
+        return parse_binary_leaklist(data)
+    return json.loads(data.decode("utf-8"), object_pairs_hook=collections.OrderedDict)
+
+
+def cmd_leaklist(args):
+    with open(args.jsleaklist, "rb") as f:
+        is_binary = f.read(len(LEAKLIST_MAGIC)) == LEAKLIST_MAGIC
+    leak_list = load_leaklist(args.jsleaklist)
+    if is_binary:
+        output = args.output or args.jsleaklist + ".json"
+        with open(output, "w", encoding="utf-8") as f:
+            f.write(json.dumps(leak_list, ensure_ascii=False, separators=(",", ":")))
+    else:
+        output = args.output or args.jsleaklist + ".bin"
+        with open(output, "wb") as f:
+            f.write(build_binary_leaklist(leak_list))
+    print("written %s, %d leaked objects" % (output, len(leak_list.get("leakObjList", []))))
+    return 0
+
+
+def load_leak_hashes(path):
+    leak_list = load_leaklist(path)
+    if isinstance(leak_list, dict):
+        leak_list = leak_list.get("leakObjList", [])
+    return {int(leak["hash"]) for leak in leak_list if "hash" in leak}
+
+
+class HeapGraph:
+    """Node and edge arrays of a heapsnapshot, addressed by node ordinal."""
+
+    def __init__(self, snapshot):
+        meta = snapshot["snapshot"]["meta"]
+        self.node_fields = meta["node_fields"]
+        self.edge_fields = meta["edge_fields"]
+        self.edge_types = meta["edge_types"][self.edge_fields.index("type")]
+        self.nodes = snapshot["nodes"]
+        self.edges = snapshot["edges"]
+        self.node_width = len(self.node_fields)
+        self.edge_width = len(self.edge_fields)
+        self.node_count = len(self.nodes) // self.node_width
+        edge_count_field = self.node_fields.index("edge_count")
+        self.first_edge = [0] * (self.node_count + 1)
+        for ordinal in range(self.node_count):
+            self.first_edge[ordinal + 1] = (self.first_edge[ordinal] +
+                                            self.nodes[ordinal * self.node_width + edge_count_field])
+        self.type_field = self.edge_fields.index("type")
+        self.to_field = self.edge_fields.index("to_node")
+
+    def node_field(self, ordinal, name):
+        return self.nodes[ordinal * self.node_width + self.node_fields.index(name)]
+
+    def children(self, ordinal, skip_weak):
+        for edge in range(self.first_edge[ordinal], self.first_edge[ordinal + 1]):
+            base = edge * self.edge_width
+            if skip_weak and self.edge_types[self.edges[base + self.type_field]] == "weak":
+                continue
+            yield edge, self.edges[base + self.to_field] // self.node_width
+
+    def walk(self, starts, blocked=(), parents=None):
+        seen = set(starts)
+        queue = collections.deque(starts)
+        while queue:
+            ordinal = queue.popleft()
+            for _, child in self.children(ordinal, True):
+                if child in seen or child in blocked:
+                    continue
+                seen.add(child)
+                if parents is not None:
+                    parents[child] = ordinal
+                queue.append(child)
+        return seen
+
+
+def find_leaked_nodes(graph, leak_hashes, node_ids):
+    if node_ids:
+        return [ordinal for ordinal in range(graph.node_count) if graph.node_field(ordinal, "id") in node_ids]
+    if "hash" not in graph.node_fields:
+        raise ValueError("snapshot has no hash node field, pass the leaked node ids with --ids")
+    return [ordinal for ordinal in range(graph.node_count) if graph.node_field(ordinal, "hash") in leak_hashes]
+
+
+def focus_nodes(graph, leaked):
+    parents = {}
+    graph.walk([0], parents=parents)
+    keep = set(leaked)
+    for ordinal in leaked:
+        while ordinal in parents:
+            ordinal = parents[ordinal]
+            if ordinal in keep:
+                break
+            keep.add(ordinal)
+    keep.add(0)
+    # whatever the leaks reach but the root cannot reach without them is retained by the leaks alone
+    without_leaks = graph.walk([0], blocked=set(leaked))
+    keep.update(graph.walk(leaked) - without_leaks)
+    return keep
+
+
+def write_focused(snapshot, graph, keep):
+    kept = sorted(keep)
+    new_ordinal = {ordinal: index for index, ordinal in enumerate(kept)}
+    strings = snapshot["strings"]
+    string_ids = {}
+
+    def remap_string(index):
+        if index not in string_ids:
+            string_ids[index] = len(string_ids)
+        return string_ids[index]
+
+    name_field = graph.node_fields.index("name")
+    edge_count_field = graph.node_fields.index("edge_count")
+    name_edge_field = graph.edge_fields.index("name_or_index")
+    nodes = []
+    edges = []
+    for ordinal in kept:
+        node = graph.nodes[ordinal * graph.node_width:(ordinal + 1) * graph.node_width]
+        node[name_field] = remap_string(node[name_field])
+        edge_count = 0
+        for edge, child in graph.children(ordinal, False):
+            if child not in new_ordinal:
+                continue
+            values = graph.edges[edge * graph.edge_width:(edge + 1) * graph.edge_width]
+            if graph.edge_types[values[graph.type_field]] not in ("element", "hidden"):
+                values[name_edge_field] = remap_string(values[name_edge_field])
+            values[graph.to_field] = new_ordinal[child] * graph.node_width
+            edges.extend(values)
+            edge_count += 1
+        node[edge_count_field] = edge_count
+        nodes.extend(node)
+    focused = dict(snapshot)
+    focused["snapshot"] = dict(snapshot["snapshot"])
+    focused["snapshot"]["node_count"] = len(kept)
+    focused["snapshot"]["edge_count"] = len(edges) // graph.edge_width
+    focused["nodes"] = nodes
+    focused["edges"] = edges
+    focused["strings"] = [strings[index] for index, _ in sorted(string_ids.items(), key=lambda item: item[1])]
+    for key in ("trace_function_infos", "trace_tree", "samples", "locations"):
+        if key in focused:
+            focused[key] = []
+    return focused
+
+
+def cmd_focus(args):
+    with open(args.heapsnapshot, "r") as f:
+        snapshot = json.load(f)
+    graph = HeapGraph(snapshot)
+    node_ids = {int(node_id) for node_id in args.ids.split(",")} if args.ids else set()
+    try:
+        leaked = find_leaked_nodes(graph, load_leak_hashes(args.jsleaklist), node_ids)
+    except ValueError as error:
+        print(error, file=sys.stderr)
+        return 1
+    if not leaked:
+        print("no leaked object found in the snapshot", file=sys.stderr)
+        return 1
+    keep = focus_nodes(graph, leaked)
+    output = args.output or args.heapsnapshot + ".focus.heapsnapshot"
+    with open(output, "w") as f:
+        json.dump(write_focused(snapshot, graph, keep), f, separators=(",", ":"))
+    print("written %s, %d of %d nodes for %d leaked objects" % (output, len(keep), graph.node_count, len(leaked)))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="jsLeakWatcher rawheap tool")
+    sub = parser.add_subparsers(dest="command")
+    info = sub.add_parser("info", help="show the layout of a rawheap file")
+    info.add_argument("rawheap")
+    info.set_defaults(func=cmd_info)
+    extract = sub.add_parser("extract", help="read a range of the heap bytes without inflating the whole dump")
+    extract.add_argument("rawheap")
+    extract.add_argument("--offset", type=int, required=True)
+    extract.add_argument("--length", type=int, required=True)
+    extract.add_argument("-o", "--output", help="output path, defaults to stdout")
+    extract.set_defaults(func=cmd_extract)
+    recombine = sub.add_parser("recombine", help="inflate a compressed dump and inline its metadata sidecar")
+    recombine.add_argument("rawheap")
+    recombine.add_argument("-s", "--sidecar-dir", help="directory holding the sidecar, defaults to the rawheap one")
+    recombine.add_argument("-o", "--output", help="output path, defaults to <rawheap>.full")
+    recombine.set_defaults(func=cmd_recombine)
+    merge = sub.add_parser("merge", help="rebuild the full rawheap of a delta dump from its base")
+    merge.add_argument("rawheap")
+    merge.add_argument("-b", "--base-dir", help="directory holding the base dump, defaults to the rawheap one")
+    merge.add_argument("-o", "--output", help="output path, defaults to <rawheap>.full")
+    merge.set_defaults(func=cmd_merge)
+    focus = sub.add_parser("focus", help="keep only leaked objects, their retainer paths and what they retain")
+    focus.add_argument("heapsnapshot")
+    focus.add_argument("jsleaklist")
+    focus.add_argument("--ids", help="comma separated snapshot node ids of the leaked objects")
+    focus.add_argument("-o", "--output", help="output path, defaults to <heapsnapshot>.focus.heapsnapshot")
+    focus.set_defaults(func=cmd_focus)
+    leaklist = sub.add_parser("leaklist", help="convert a jsleaklist between the binary and the JSON layout")
+    leaklist.add_argument("jsleaklist")
+    leaklist.add_argument("-o", "--output", help="output path, defaults to <jsleaklist>.json or <jsleaklist>.bin")
+    leaklist.set_defaults(func=cmd_leaklist)
+    args = parser.parse_args()
+    if not hasattr(args, "func"):
+        parser.print_help()
+        return 1
+    return args.func(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())